@@ -0,0 +1,669 @@
+/**
+ * @file bench_safe_runtime.c
+ * @brief Micro-benchmarks for the safe_runtime helpers.
+ *
+ * Usage: bench_safe_runtime [iterations]
+ *
+ * Prints the mean time per call of each helper in nanoseconds. Output that
+ * the helpers write to stdout (process_data) is sent to /dev/null while it
+ * is being measured.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "safe_runtime.h"
+
+/* Rule 41: Constants use UPPER_CASE */
+#define DEFAULT_ITERATIONS 1000000L
+#define COPY_BUFFER_SIZE   64
+#define CONFIG_FILE_SIZE   4096
+#define BATCH_FIELDS       32
+#define LOAD_FILES         3000
+#define LARGE_FILE_DATA    ((size_t)16 << 20)
+#define APPEND_LINE        64
+#define CONVERT_COUNT      ((size_t)1 << 20)
+
+/* Keeps results observable so calls are not optimized away */
+static volatile long g_sink = 0;
+
+/**
+ * @brief Read the monotonic clock in nanoseconds.
+ */
+static double now_ns(void)
+{
+    struct timespec ts = {0, 0};
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+    {
+        return 0.0;
+    }
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Print one result line.
+ */
+static void report(const char *name, double elapsed_ns, long iterations)
+{
+    printf("%-32s %12.2f ns/op\n", name, elapsed_ns / (double)iterations);
+}
+
+static void bench_safe_string_copy(long iterations)
+{
+    char        dest[COPY_BUFFER_SIZE];
+    const char *short_src = "Hello, World!";
+    char        long_src[1024];
+
+    memset(long_src, 'x', sizeof(long_src) - 1);
+    long_src[sizeof(long_src) - 1] = '\0';
+
+    double start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        g_sink += safe_string_copy(dest, sizeof(dest), short_src);
+    }
+    report("safe_string_copy (13 B)", now_ns() - start, iterations);
+
+    start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        g_sink += safe_string_copy(dest, sizeof(dest), long_src);
+    }
+    report("safe_string_copy (1 KiB, trunc)", now_ns() - start, iterations);
+
+    char wide_dest[sizeof(long_src)];
+
+    start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        g_sink += safe_string_copy(wide_dest, sizeof(wide_dest), long_src);
+    }
+    report("safe_string_copy (1 KiB)", now_ns() - start, iterations);
+
+    size_t length = 0;
+
+    start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        g_sink += safe_string_copy_bounded(dest, sizeof(dest), long_src, &length);
+        g_sink += (long)length;
+    }
+    report("safe_string_copy_bounded (trunc)", now_ns() - start, iterations);
+}
+
+static void bench_safe_string_copy_batch(long iterations)
+{
+    /* A record of BATCH_FIELDS short fields, copied per field and batched */
+    static const char *const names[] = {"id", "name", "email", "city", "country", "postcode"};
+    char            dest[BATCH_FIELDS][32];
+    StringCopyField fields[BATCH_FIELDS];
+    uint64_t        truncated = 0;
+
+    for (size_t i = 0; i < BATCH_FIELDS; i++)
+    {
+        fields[i].dest      = dest[i];
+        fields[i].dest_size = sizeof(dest[i]);
+        fields[i].src       = names[i % (sizeof(names) / sizeof(names[0]))];
+    }
+
+    double start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        for (size_t f = 0; f < BATCH_FIELDS; f++)
+        {
+            g_sink += safe_string_copy(fields[f].dest, fields[f].dest_size, fields[f].src);
+        }
+    }
+    report("safe_string_copy x32 fields", now_ns() - start, iterations);
+
+    start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        g_sink += safe_string_copy_batch(fields, BATCH_FIELDS, &truncated);
+        g_sink += (long)truncated;
+    }
+    report("safe_string_copy_batch (32)", now_ns() - start, iterations);
+}
+
+static void bench_convert_long_to_int(long iterations)
+{
+    int converted = 0;
+
+    double start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        g_sink += convert_long_to_int(i, &converted);
+        g_sink += converted;
+    }
+    report("convert_long_to_int", now_ns() - start, iterations);
+
+    /* Bulk: 64-bit IDs narrowed per element and in one array call */
+    long *values = malloc(CONVERT_COUNT * sizeof(*values));
+    int  *out    = malloc(CONVERT_COUNT * sizeof(*out));
+    if (values == NULL || out == NULL)
+    {
+        fprintf(stderr, "Error: Cannot allocate conversion arrays\n");
+        free(values);
+        free(out);
+        return;
+    }
+    for (size_t i = 0; i < CONVERT_COUNT; i++)
+    {
+        values[i] = (long)(i * 2654435761u % 2000000000u) - 1000000000L;
+    }
+
+    long passes = iterations / 100000 > 0 ? iterations / 100000 : 1;
+    start = now_ns();
+    for (long pass = 0; pass < passes; pass++)
+    {
+        for (size_t i = 0; i < CONVERT_COUNT; i++)
+        {
+            if (convert_long_to_int(values[i], &out[i]) != ERROR_NONE)
+            {
+                break;
+            }
+        }
+        g_sink += out[pass % CONVERT_COUNT];
+    }
+    report("convert_long_to_int (1M array)", now_ns() - start, passes * (long)CONVERT_COUNT);
+
+    start = now_ns();
+    for (long pass = 0; pass < passes; pass++)
+    {
+        size_t index = 0;
+
+        g_sink += convert_long_array_to_int(values, out, CONVERT_COUNT, &index);
+        g_sink += out[pass % CONVERT_COUNT] + (long)index;
+    }
+    report("convert_long_array_to_int", now_ns() - start, passes * (long)CONVERT_COUNT);
+
+    free(values);
+    free(out);
+}
+
+static void bench_file_data(long iterations)
+{
+    double start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        FileData *data = create_file_data(1024);
+        if (data == NULL)
+        {
+            fprintf(stderr, "Error: create_file_data failed\n");
+            return;
+        }
+        g_sink += (long)data->size;
+        destroy_file_data(&data);
+    }
+    report("create/destroy_file_data (1 KiB)", now_ns() - start, iterations);
+
+    start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        FileDataInline *data = create_file_data_inline(1024);
+        if (data == NULL)
+        {
+            fprintf(stderr, "Error: create_file_data_inline failed\n");
+            return;
+        }
+        g_sink += (long)data->size + data->content[0];
+        destroy_file_data_inline(&data);
+    }
+    report("create/destroy_file_data_inline", now_ns() - start, iterations);
+
+    Arena *arena = arena_create(0);
+    if (arena == NULL)
+    {
+        fprintf(stderr, "Error: arena_create failed\n");
+        return;
+    }
+    start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        FileData *data = create_file_data_in(arena, 1024);
+        if (data == NULL)
+        {
+            fprintf(stderr, "Error: create_file_data_in failed\n");
+            break;
+        }
+        g_sink += (long)data->size;
+        destroy_file_data(&data);
+        arena_reset(arena);  /* End of request */
+    }
+    report("create_file_data_in arena (1 KiB)", now_ns() - start, iterations);
+    arena_destroy(&arena);
+
+    /* Large buffer of which only the first page is used: creation faults
+     * in zero pages lazily and destroy wipes only resident pages, so
+     * neither touches the untouched rest */
+    long large_iterations = (iterations / 1000 > 0) ? iterations / 1000 : 1;
+    start = now_ns();
+    for (long i = 0; i < large_iterations; i++)
+    {
+        FileData *data = create_file_data(LARGE_FILE_DATA);
+        if (data == NULL)
+        {
+            fprintf(stderr, "Error: create_file_data failed\n");
+            return;
+        }
+        data->content[0] = 'x';
+        g_sink += data->content[0];
+        destroy_file_data(&data);
+    }
+    report("create/destroy_file_data (16 MiB)", now_ns() - start, large_iterations);
+
+    /* Build content incrementally; growth is amortised over the appends */
+    char line[APPEND_LINE];
+    memset(line, 'k', sizeof(line));
+    FileData *built = create_file_data_empty(0);
+    if (built == NULL)
+    {
+        fprintf(stderr, "Error: create_file_data_empty failed\n");
+        return;
+    }
+    start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        if (file_data_append(built, line, sizeof(line)) != ERROR_NONE)
+        {
+            fprintf(stderr, "Error: file_data_append failed\n");
+            break;
+        }
+    }
+    report("file_data_append (64 B)", now_ns() - start, iterations);
+    g_sink += (long)built->size;
+    destroy_file_data(&built);
+}
+
+static int sum_chunk(const char *chunk, size_t length, void *context)
+{
+    (void)context;
+    g_sink += chunk[length - 1];
+    return ERROR_NONE;
+}
+
+static void bench_secure_wipe(long iterations)
+{
+    /* 8 MiB: larger than the last-level cache on most machines */
+    size_t size   = (size_t)8 << 20;
+    char  *buffer = malloc(size);
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Error: Cannot allocate wipe buffer\n");
+        return;
+    }
+    memset(buffer, 'w', size);
+
+    long   wipes = iterations / 10000 > 0 ? iterations / 10000 : 1;
+    double start = now_ns();
+    for (long i = 0; i < wipes; i++)
+    {
+        memset(buffer, 0, size);
+        g_sink += buffer[i % 64];
+    }
+    report("memset (8 MiB)", now_ns() - start, wipes);
+
+    start = now_ns();
+    for (long i = 0; i < wipes; i++)
+    {
+        secure_wipe(buffer, size);
+        g_sink += buffer[i % 64];
+    }
+    report("secure_wipe (8 MiB)", now_ns() - start, wipes);
+    free(buffer);
+}
+
+static void bench_error_reporting(long iterations)
+{
+    char buffer[16];
+    long calls = iterations / 10 > 0 ? iterations / 10 : 1;
+
+    /* Default handler, with stderr sent to /dev/null while measuring */
+    if (fflush(stderr) != 0)
+    {
+        return;
+    }
+    int saved_stderr = dup(STDERR_FILENO);
+    int devnull      = open("/dev/null", O_WRONLY);
+    if (saved_stderr < 0 || devnull < 0 || dup2(devnull, STDERR_FILENO) < 0)
+    {
+        fprintf(stderr, "Error: Cannot redirect stderr\n");
+        if (saved_stderr >= 0)
+        {
+            (void)close(saved_stderr);
+        }
+        if (devnull >= 0)
+        {
+            (void)close(devnull);
+        }
+        return;
+    }
+    double start = now_ns();
+    for (long i = 0; i < calls; i++)
+    {
+        g_sink += read_config_file(NULL, buffer, sizeof(buffer));
+    }
+    (void)fflush(stderr);
+    double elapsed = now_ns() - start;
+    (void)dup2(saved_stderr, STDERR_FILENO);
+    (void)close(saved_stderr);
+    (void)close(devnull);
+    report("error report (stderr)", elapsed, calls);
+
+    /* Lock-free ring, drained in batches as a consumer thread would */
+    ErrorRing *ring = error_ring_create(1024);
+    if (ring == NULL)
+    {
+        fprintf(stderr, "Error: error_ring_create failed\n");
+        return;
+    }
+    ErrorReporter reporter = {error_ring_handler, ring};
+    ErrorRecord   records[256];
+    error_reporter_set(&reporter);
+    start = now_ns();
+    for (long i = 0; i < calls; i++)
+    {
+        g_sink += read_config_file(NULL, buffer, sizeof(buffer));
+        if ((i & 255) == 255)
+        {
+            g_sink += (long)error_ring_drain(ring, records, 256);
+        }
+    }
+    report("error report (ring)", now_ns() - start, calls);
+    error_reporter_set(NULL);
+    error_ring_destroy(&ring);
+}
+
+static void bench_logger(long iterations)
+{
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Error: Cannot open /dev/null\n");
+        return;
+    }
+    Logger *logger = logger_create(fd, 65536);
+    if (logger == NULL)
+    {
+        fprintf(stderr, "Error: logger_create failed\n");
+        (void)close(fd);
+        return;
+    }
+
+    /* Caller-side cost only; the drainer thread formats and writes */
+    double start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        g_sink += logger_log(logger, LOG_LEVEL_INFO, "request served", "/index.html");
+    }
+    report("logger_log", now_ns() - start, iterations);
+
+    /* Including the drainer's work, until everything is written */
+    start = now_ns();
+    for (long i = 0; i < iterations; i++)
+    {
+        g_sink += logger_log(logger, LOG_LEVEL_INFO, "request served", "/index.html");
+    }
+    logger_flush(logger);
+    report("logger_log + flush", now_ns() - start, iterations);
+    g_sink += (long)logger_dropped(logger);
+
+    logger_destroy(&logger);
+    (void)close(fd);
+}
+
+static void bench_read_config_file(long iterations)
+{
+    char path[]                   = "/tmp/bench_safe_runtime_XXXXXX";
+    char content[CONFIG_FILE_SIZE];
+    char buffer[CONFIG_FILE_SIZE + 1];
+
+    /* Rule 20: Check mkstemp return value */
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Error: Cannot create temp file: %s\n", strerror(errno));
+        return;
+    }
+
+    memset(content, 'k', sizeof(content));
+    ssize_t written = write(fd, content, sizeof(content));
+    if (close(fd) != 0 || written != (ssize_t)sizeof(content))
+    {
+        fprintf(stderr, "Error: Cannot write temp file\n");
+        (void)unlink(path);
+        return;
+    }
+
+    long reads = iterations / 100 > 0 ? iterations / 100 : 1;
+    double start = now_ns();
+    for (long i = 0; i < reads; i++)
+    {
+        g_sink += read_config_file(path, buffer, sizeof(buffer));
+    }
+    report("read_config_file (4 KiB)", now_ns() - start, reads);
+
+    config_cache_clear();
+    start = now_ns();
+    for (long i = 0; i < reads; i++)
+    {
+        g_sink += read_config_file_cached(path, buffer, sizeof(buffer));
+    }
+    report("read_config_file_cached (4 KiB)", now_ns() - start, reads);
+    config_cache_clear();
+
+    ConfigView view = {NULL, 0};
+
+    start = now_ns();
+    for (long i = 0; i < reads; i++)
+    {
+        if (map_config_file(path, &view) == ERROR_NONE)
+        {
+            g_sink += view.data[view.size - 1];
+            unmap_config_file(&view);
+        }
+    }
+    report("map/unmap_config_file (4 KiB)", now_ns() - start, reads);
+
+    char     chunk[1024];
+    uint64_t total = 0;
+
+    start = now_ns();
+    for (long i = 0; i < reads; i++)
+    {
+        g_sink += read_config_chunks(path, chunk, sizeof(chunk), sum_chunk, NULL, &total);
+        g_sink += (long)total;
+    }
+    report("read_config_chunks (4 KiB/1 KiB)", now_ns() - start, reads);
+
+    (void)unlink(path);
+}
+
+static void bench_load_config_files(long iterations)
+{
+    char        dir[]  = "/tmp/bench_safe_runtime_XXXXXX";
+    char      (*names)[64] = calloc(LOAD_FILES, sizeof(*names));
+    const char **paths = calloc(LOAD_FILES, sizeof(*paths));
+    FileData   **files = calloc(LOAD_FILES, sizeof(*files));
+    char         buffer[CONFIG_FILE_SIZE];
+    size_t       created = 0;
+
+    /* Rule 20: Check every allocation and file operation */
+    if (names == NULL || paths == NULL || files == NULL || mkdtemp(dir) == NULL)
+    {
+        fprintf(stderr, "Error: Cannot set up load_config_files benchmark\n");
+        free(names);
+        free(paths);
+        free(files);
+        return;
+    }
+    for (; created < LOAD_FILES; created++)
+    {
+        (void)snprintf(names[created], sizeof(names[created]), "%s/%zu.cfg", dir, created);
+        paths[created] = names[created];
+
+        int fd = open(names[created], O_WRONLY | O_CREAT | O_EXCL, 0600);
+        if (fd < 0 || write(fd, "key=value\nmode=fast\n", 20) != 20 || close(fd) != 0)
+        {
+            fprintf(stderr, "Error: Cannot create %s\n", names[created]);
+            break;
+        }
+    }
+
+    long rounds = iterations / 100000 > 0 ? iterations / 100000 : 1;
+    if (created == LOAD_FILES)
+    {
+        double start = now_ns();
+        for (long r = 0; r < rounds; r++)
+        {
+            for (size_t i = 0; i < LOAD_FILES; i++)
+            {
+                g_sink += read_config_file(paths[i], buffer, sizeof(buffer));
+            }
+        }
+        report("read_config_file x3000", now_ns() - start, rounds);
+
+        for (int fallback = 0; fallback < 2; fallback++)
+        {
+            if (fallback != 0 && setenv("SAFE_RUNTIME_NO_IO_URING", "1", 1) != 0)
+            {
+                break;
+            }
+            start = now_ns();
+            for (long r = 0; r < rounds; r++)
+            {
+                g_sink += load_config_files(paths, LOAD_FILES, files, NULL);
+                for (size_t i = 0; i < LOAD_FILES; i++)
+                {
+                    destroy_file_data(&files[i]);
+                }
+            }
+            report(fallback != 0 ? "load_config_files x3000 (threads)" : "load_config_files x3000",
+                   now_ns() - start, rounds);
+        }
+        (void)unsetenv("SAFE_RUNTIME_NO_IO_URING");
+    }
+
+    for (size_t i = 0; i < created; i++)
+    {
+        (void)unlink(names[i]);
+    }
+    (void)rmdir(dir);
+    free(names);
+    free(paths);
+    free(files);
+}
+
+static void bench_process_data(long iterations)
+{
+    /* Rule 20: Check all descriptor operations */
+    if (fflush(stdout) != 0)
+    {
+        return;
+    }
+    int saved_stdout = dup(STDOUT_FILENO);
+    int devnull      = open("/dev/null", O_WRONLY);
+    if (saved_stdout < 0 || devnull < 0 || dup2(devnull, STDOUT_FILENO) < 0)
+    {
+        fprintf(stderr, "Error: Cannot redirect stdout\n");
+        if (saved_stdout >= 0)
+        {
+            (void)close(saved_stdout);
+        }
+        if (devnull >= 0)
+        {
+            (void)close(devnull);
+        }
+        return;
+    }
+
+    long calls = iterations / 10 > 0 ? iterations / 10 : 1;
+    double start = now_ns();
+    for (long i = 0; i < calls; i++)
+    {
+        g_sink += process_data("Hello, World!");
+    }
+    (void)fflush(stdout);
+    double elapsed = now_ns() - start;
+
+    Arena *arena         = arena_create(0);
+    double arena_elapsed = 0.0;
+    if (arena != NULL)
+    {
+        start = now_ns();
+        for (long i = 0; i < calls; i++)
+        {
+            g_sink += process_data_in(arena, "Hello, World!");
+        }
+        (void)fflush(stdout);
+        arena_elapsed = now_ns() - start;
+        arena_destroy(&arena);
+    }
+
+    /* Same lines, 64 per batch, through one reused buffer */
+    const char *inputs[64];
+    static char output[4096];
+    for (size_t i = 0; i < 64; i++)
+    {
+        inputs[i] = "Hello, World!";
+    }
+    long batches = calls / 64 > 0 ? calls / 64 : 1;
+    start        = now_ns();
+    for (long i = 0; i < batches; i++)
+    {
+        g_sink += process_data_batch(devnull, inputs, 64, output, sizeof(output), NULL);
+    }
+    double batch_elapsed = now_ns() - start;
+
+    (void)dup2(saved_stdout, STDOUT_FILENO);
+    (void)close(saved_stdout);
+    (void)close(devnull);
+
+    report("process_data", elapsed, calls);
+    report("process_data_in arena", arena_elapsed, calls);
+    report("process_data_batch (per input)", batch_elapsed, batches * 64);
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = DEFAULT_ITERATIONS;
+
+    if (argc > 1)
+    {
+        char *end = NULL;
+
+        errno      = 0;
+        iterations = strtol(argv[1], &end, 10);
+        /* Rule 20: Validate conversion result */
+        if (errno != 0 || end == argv[1] || *end != '\0' || iterations <= 0)
+        {
+            fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("safe_runtime benchmarks (%ld iterations)\n\n", iterations);
+
+    bench_safe_string_copy(iterations);
+    bench_safe_string_copy_batch(iterations);
+    bench_convert_long_to_int(iterations);
+    bench_file_data(iterations);
+    bench_secure_wipe(iterations);
+    bench_error_reporting(iterations);
+    bench_logger(iterations);
+    bench_read_config_file(iterations);
+    bench_load_config_files(iterations);
+    bench_process_data(iterations);
+
+    return EXIT_SUCCESS;
+}
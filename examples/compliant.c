@@ -5,6 +5,9 @@
  * This file demonstrates compliant code patterns for each rule.
  * Run: clang-tidy compliant.c -- to verify no warnings.
  *
+ * The helpers below are also packaged as the safe_runtime library
+ * (include/safe_runtime.h); link that instead of copying them.
+ *
  * Rules demonstrated:
  * - Rule 20: Check all return values
  * - Rule 21: Prevent buffer overflows
@@ -0,0 +1,306 @@
+/**
+ * @file safe_convert.h
+ * @brief Header-only checked conversions between arithmetic types.
+ *
+ * Generalises convert_long_to_int() to every pair of standard integer and
+ * floating types. In C, SAFE_CONVERT(value, &out) picks the right function
+ * from the types of value and out with _Generic; in C++,
+ * safe_runtime::checked_convert(value, &out) does the same with templates.
+ *
+ * Everything is inline and the limits are constants, so the compiler drops
+ * any test the source type cannot fail: int16_t to int compiles to a plain
+ * move, int64_t to uint16_t to one compare-and-branch.
+ *
+ * Conversions check range only, like a cast that refuses to wrap:
+ * - Integer to integer: the value must be representable in the target.
+ * - Floating to integer: the value is truncated toward zero and must then
+ *   be representable; NaN and infinities are rejected.
+ * - Integer to floating: always succeeds, rounding to nearest.
+ * - Floating to narrower floating: rounds; finite values beyond the
+ *   target's largest finite value are rejected, NaN and infinities pass.
+ *
+ * Rules followed:
+ * - Rule 20: Every conversion returns a status code
+ * - Rule 22: Output pointers are validated
+ * - Rule 30: Narrowing conversions are range checked
+ */
+
+#ifndef SAFE_CONVERT_H
+#define SAFE_CONVERT_H
+
+#include <float.h>
+#include <limits.h>
+#include <stdint.h>
+
+#include "safe_runtime.h"
+
+#ifndef __cplusplus
+
+/* --------------------------------------------------------------------------
+ * C: one inline function per (source kind, target type)
+ *
+ * Integer sources narrower than intmax_t arrive as intmax_t ("signed"),
+ * the rest as uintmax_t ("unsigned"); the compiler still knows the
+ * original range after the widening and folds the checks accordingly.
+ * -------------------------------------------------------------------------- */
+
+/* Truncated floating value v of type F fits [TMIN, TMAX]. TMIN and the
+ * upper bound 2^n are powers of two (or 0), so both are exact in F. */
+#define SAFE_CONVERT_FLOAT_FITS(F, v, TMIN, TMAX)                                    \
+    (((v) >= (F)(TMIN) || (v) > (F)(TMIN) - (F)1) && (v) < (F)((TMAX) / 2 + 1) * (F)2)
+
+#define SAFE_CONVERT_DEFINE_INTEGER(NAME, T, TMIN, TMAX)                             \
+    static inline int safe_convert_signed_to_##NAME(intmax_t value, T *out)          \
+    {                                                                                \
+        if (out == NULL)                                                             \
+        {                                                                            \
+            return ERROR_NULL_PARAM;                                                 \
+        }                                                                            \
+        if (value < (intmax_t)(TMIN) ||                                              \
+            (value > 0 && (uintmax_t)value > (uintmax_t)(TMAX)))                     \
+        {                                                                            \
+            return ERROR_OVERFLOW;                                                   \
+        }                                                                            \
+        *out = (T)value;                                                             \
+        return ERROR_NONE;                                                           \
+    }                                                                                \
+    static inline int safe_convert_unsigned_to_##NAME(uintmax_t value, T *out)       \
+    {                                                                                \
+        if (out == NULL)                                                             \
+        {                                                                            \
+            return ERROR_NULL_PARAM;                                                 \
+        }                                                                            \
+        if (value > (uintmax_t)(TMAX))                                               \
+        {                                                                            \
+            return ERROR_OVERFLOW;                                                   \
+        }                                                                            \
+        *out = (T)value;                                                             \
+        return ERROR_NONE;                                                           \
+    }                                                                                \
+    SAFE_CONVERT_DEFINE_FLOAT_TO_INTEGER(float, float, NAME, T, TMIN, TMAX)          \
+    SAFE_CONVERT_DEFINE_FLOAT_TO_INTEGER(double, double, NAME, T, TMIN, TMAX)        \
+    SAFE_CONVERT_DEFINE_FLOAT_TO_INTEGER(ldouble, long double, NAME, T, TMIN, TMAX)
+
+#define SAFE_CONVERT_DEFINE_FLOAT_TO_INTEGER(FNAME, F, NAME, T, TMIN, TMAX)         \
+    static inline int safe_convert_##FNAME##_to_##NAME(F value, T *out)              \
+    {                                                                                \
+        if (out == NULL)                                                             \
+        {                                                                            \
+            return ERROR_NULL_PARAM;                                                 \
+        }                                                                            \
+        if (!SAFE_CONVERT_FLOAT_FITS(F, value, TMIN, TMAX))                          \
+        {                                                                            \
+            return ERROR_OVERFLOW;                                                   \
+        }                                                                            \
+        *out = (T)value;                                                             \
+        return ERROR_NONE;                                                           \
+    }
+
+#define SAFE_CONVERT_DEFINE_FLOATING(NAME, T, TMAX)                                  \
+    static inline int safe_convert_signed_to_##NAME(intmax_t value, T *out)          \
+    {                                                                                \
+        if (out == NULL)                                                             \
+        {                                                                            \
+            return ERROR_NULL_PARAM;                                                 \
+        }                                                                            \
+        *out = (T)value;                                                             \
+        return ERROR_NONE;                                                           \
+    }                                                                                \
+    static inline int safe_convert_unsigned_to_##NAME(uintmax_t value, T *out)       \
+    {                                                                                \
+        if (out == NULL)                                                             \
+        {                                                                            \
+            return ERROR_NULL_PARAM;                                                 \
+        }                                                                            \
+        *out = (T)value;                                                             \
+        return ERROR_NONE;                                                           \
+    }                                                                                \
+    SAFE_CONVERT_DEFINE_FLOAT_TO_FLOAT(float, float, NAME, T, TMAX)                  \
+    SAFE_CONVERT_DEFINE_FLOAT_TO_FLOAT(double, double, NAME, T, TMAX)                \
+    SAFE_CONVERT_DEFINE_FLOAT_TO_FLOAT(ldouble, long double, NAME, T, TMAX)
+
+/* value - value is 0 only for finite values (inf - inf and NaN give NaN) */
+#define SAFE_CONVERT_DEFINE_FLOAT_TO_FLOAT(FNAME, F, NAME, T, TMAX)                 \
+    static inline int safe_convert_##FNAME##_to_##NAME(F value, T *out)              \
+    {                                                                                \
+        if (out == NULL)                                                             \
+        {                                                                            \
+            return ERROR_NULL_PARAM;                                                 \
+        }                                                                            \
+        if (value - value == (F)0 && (value > (TMAX) || value < -(TMAX)))            \
+        {                                                                            \
+            return ERROR_OVERFLOW;                                                   \
+        }                                                                            \
+        *out = (T)value;                                                             \
+        return ERROR_NONE;                                                           \
+    }
+
+SAFE_CONVERT_DEFINE_INTEGER(schar, signed char, SCHAR_MIN, SCHAR_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(short, short, SHRT_MIN, SHRT_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(int, int, INT_MIN, INT_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(long, long, LONG_MIN, LONG_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(llong, long long, LLONG_MIN, LLONG_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(uchar, unsigned char, 0, UCHAR_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(ushort, unsigned short, 0, USHRT_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(uint, unsigned int, 0, UINT_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(ulong, unsigned long, 0, ULONG_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(ullong, unsigned long long, 0, ULLONG_MAX)
+SAFE_CONVERT_DEFINE_INTEGER(char, char, CHAR_MIN, CHAR_MAX)
+SAFE_CONVERT_DEFINE_FLOATING(float, float, FLT_MAX)
+SAFE_CONVERT_DEFINE_FLOATING(double, double, DBL_MAX)
+SAFE_CONVERT_DEFINE_FLOATING(ldouble, long double, LDBL_MAX)
+
+/* Function converting value's type to target type NAME */
+#define SAFE_CONVERT_FROM(value, NAME)                                               \
+    _Generic((value),                                                                \
+        _Bool: safe_convert_signed_to_##NAME,                                        \
+        char: safe_convert_signed_to_##NAME,                                         \
+        signed char: safe_convert_signed_to_##NAME,                                  \
+        short: safe_convert_signed_to_##NAME,                                        \
+        int: safe_convert_signed_to_##NAME,                                          \
+        long: safe_convert_signed_to_##NAME,                                         \
+        long long: safe_convert_signed_to_##NAME,                                    \
+        unsigned char: safe_convert_signed_to_##NAME,                                \
+        unsigned short: safe_convert_signed_to_##NAME,                               \
+        unsigned int: safe_convert_unsigned_to_##NAME,                               \
+        unsigned long: safe_convert_unsigned_to_##NAME,                              \
+        unsigned long long: safe_convert_unsigned_to_##NAME,                         \
+        float: safe_convert_float_to_##NAME,                                         \
+        double: safe_convert_double_to_##NAME,                                       \
+        long double: safe_convert_ldouble_to_##NAME)
+
+/**
+ * @brief Convert value to the type out points to, checking the range.
+ *
+ * Both types must be standard arithmetic types (fixed-width and size_t
+ * typedefs included); anything else fails to compile.
+ *
+ * @param value Value to convert (evaluated once)
+ * @param out Pointer to the target (evaluated once)
+ * @return ERROR_NONE on success (*out written), ERROR_OVERFLOW if value
+ *         does not fit (*out untouched), ERROR_NULL_PARAM if out is NULL
+ */
+#define SAFE_CONVERT(value, out)                                                     \
+    _Generic((out),                                                                  \
+        signed char *: SAFE_CONVERT_FROM(value, schar),                              \
+        short *: SAFE_CONVERT_FROM(value, short),                                    \
+        int *: SAFE_CONVERT_FROM(value, int),                                        \
+        long *: SAFE_CONVERT_FROM(value, long),                                      \
+        long long *: SAFE_CONVERT_FROM(value, llong),                                \
+        unsigned char *: SAFE_CONVERT_FROM(value, uchar),                            \
+        unsigned short *: SAFE_CONVERT_FROM(value, ushort),                          \
+        unsigned int *: SAFE_CONVERT_FROM(value, uint),                              \
+        unsigned long *: SAFE_CONVERT_FROM(value, ulong),                            \
+        unsigned long long *: SAFE_CONVERT_FROM(value, ullong),                      \
+        char *: SAFE_CONVERT_FROM(value, char),                                      \
+        float *: SAFE_CONVERT_FROM(value, float),                                    \
+        double *: SAFE_CONVERT_FROM(value, double),                                  \
+        long double *: SAFE_CONVERT_FROM(value, ldouble))((value), (out))
+
+#else /* __cplusplus */
+
+/* --------------------------------------------------------------------------
+ * C++: function templates; every range test is a constant expression
+ * discarded with if constexpr when it cannot fail. Requires C++17.
+ * -------------------------------------------------------------------------- */
+
+#include <limits>
+#include <type_traits>
+
+namespace safe_runtime
+{
+
+/**
+ * @brief Whether value survives conversion to To (see the file comment).
+ */
+template <typename To, typename From>
+constexpr bool fits(From value) noexcept
+{
+    static_assert(std::is_arithmetic_v<To> && std::is_arithmetic_v<From>,
+                  "safe_runtime::fits needs arithmetic types");
+    using ToLimits   = std::numeric_limits<To>;
+    using FromLimits = std::numeric_limits<From>;
+
+    if constexpr (std::is_integral_v<From> && std::is_integral_v<To>)
+    {
+        /* Digits exclude the sign bit, so more digits means a wider range
+         * on the positive side */
+        constexpr bool wider = FromLimits::digits <= ToLimits::digits;
+
+        if constexpr (std::is_signed_v<From> && !std::is_signed_v<To>)
+        {
+            if (value < 0)
+            {
+                return false;
+            }
+        }
+        if constexpr (std::is_signed_v<From> && std::is_signed_v<To> && !wider)
+        {
+            if (value < static_cast<From>(ToLimits::min()))
+            {
+                return false;
+            }
+        }
+        if constexpr (wider)
+        {
+            return true;
+        }
+        else
+        {
+            return value <= static_cast<From>(ToLimits::max());
+        }
+    }
+    else if constexpr (std::is_floating_point_v<From> && std::is_integral_v<To>)
+    {
+        /* Powers of two, exact in From; see SAFE_CONVERT_FLOAT_FITS */
+        constexpr From lower = static_cast<From>(ToLimits::min());
+        constexpr From upper = static_cast<From>(ToLimits::max() / 2 + 1) * From(2);
+
+        return (value >= lower || value > lower - From(1)) && value < upper;
+    }
+    else if constexpr (std::is_floating_point_v<From> && std::is_floating_point_v<To>)
+    {
+        if constexpr (FromLimits::max_exponent <= ToLimits::max_exponent)
+        {
+            return true;
+        }
+        else
+        {
+            constexpr From limit = static_cast<From>(ToLimits::max());
+
+            return !(value - value == From(0) && (value > limit || value < -limit));
+        }
+    }
+    else
+    {
+        return true;  /* Integer to floating: always in range */
+    }
+}
+
+/**
+ * @brief Convert value to *out, checking the range first.
+ *
+ * @param value Value to convert
+ * @param out Target; untouched unless the conversion succeeds
+ * @return ERROR_NONE, ERROR_OVERFLOW or ERROR_NULL_PARAM
+ */
+template <typename To, typename From>
+constexpr int checked_convert(From value, To *out) noexcept
+{
+    if (out == nullptr)
+    {
+        return ERROR_NULL_PARAM;
+    }
+    if (!fits<To>(value))
+    {
+        return ERROR_OVERFLOW;
+    }
+    *out = static_cast<To>(value);
+    return ERROR_NONE;
+}
+
+} /* namespace safe_runtime */
+
+#endif /* __cplusplus */
+
+#endif /* SAFE_CONVERT_H */
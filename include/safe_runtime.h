@@ -0,0 +1,742 @@
+/**
+ * @file safe_runtime.h
+ * @brief Safe runtime helpers shared by projects using this framework.
+ *
+ * These are the helpers demonstrated in examples/compliant.c, packaged as
+ * the safe_runtime library so projects link one audited copy instead of
+ * carrying their own. Semantics and return codes match the example.
+ *
+ * Rules followed:
+ * - Rule 20: Every fallible function returns a status code
+ * - Rule 21: All copies are bounded by the destination size
+ * - Rule 22: All pointer parameters are validated
+ * - Rule 23: Resources are released on every path
+ * - Rule 24: Destroy functions clear the caller's pointer or handle
+ * - Rule 25: All memory handed out is initialized (heap or arena)
+ * - Rule 30: Narrowing conversions are range checked
+ */
+
+#ifndef SAFE_RUNTIME_H
+#define SAFE_RUNTIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Rule 41: Types use CamelCase */
+typedef struct Arena Arena;
+
+typedef struct FileData
+{
+    char   *content;
+    size_t  size;
+    size_t  capacity;  /* Bytes allocated for content (>= size) */
+    int     valid;
+    Arena  *arena;     /* Owning arena, or NULL when heap-allocated */
+} FileData;
+
+/* FileData with its content stored inline; see create_file_data_inline() */
+typedef struct FileDataInline
+{
+    size_t size;
+    int    valid;
+#if defined(__cplusplus) && defined(__GNUC__)
+    __extension__  /* Flexible array members are a GNU extension in C++ */
+#endif
+    char   content[];
+} FileDataInline;
+
+/* Allocation point in an Arena; see arena_mark() */
+typedef struct ArenaMark
+{
+    void   *block;
+    size_t  used;
+} ArenaMark;
+
+typedef enum ErrorCode
+{
+    ERROR_NONE           = 0,
+    ERROR_NULL_PARAM     = -1,
+    ERROR_FILE_OPEN      = -2,
+    ERROR_FILE_READ      = -3,
+    ERROR_MEMORY         = -4,
+    ERROR_OVERFLOW       = -5,
+    ERROR_INVALID_INPUT  = -6,
+    ERROR_TRUNCATED      = -7,
+    ERROR_FILE_WRITE     = -8
+} ErrorCode;
+
+/* Read-only view of a mapped file; see map_config_file() */
+typedef struct ConfigView
+{
+    const char *data;
+    size_t      size;
+} ConfigView;
+
+/* Streaming reader state; see config_reader_open() */
+typedef struct ConfigReader
+{
+    void     *file;   /* FILE *, opaque to keep <stdio.h> out of this header */
+    uint64_t  total;  /* Bytes delivered so far */
+} ConfigReader;
+
+/* Receives one chunk; return ERROR_NONE to continue or a negative code to stop */
+typedef int (*ConfigChunkFn)(const char *chunk, size_t length, void *context);
+
+/* One field of a safe_string_copy_batch() call */
+typedef struct StringCopyField
+{
+    char       *dest;
+    size_t      dest_size;
+    const char *src;
+} StringCopyField;
+
+typedef enum ErrorSeverity
+{
+    ERROR_SEVERITY_ERROR   = 0,
+    ERROR_SEVERITY_WARNING = 1
+} ErrorSeverity;
+
+/* One reported failure; see error_reporter_set() */
+typedef struct ErrorEvent
+{
+    ErrorSeverity  severity;
+    int            code;       /* ErrorCode; ERROR_NONE for warnings */
+    int            sys_errno;  /* errno describing the failure, or 0 */
+    int            has_value;  /* Non-zero when value is meaningful */
+    long           value;      /* Offending value, e.g. for ERROR_OVERFLOW */
+    const char    *function;   /* Reporting function; static string */
+    const char    *message;    /* What failed; static string */
+    const char    *subject;    /* What it failed on (e.g. a path) or NULL;
+                                  valid only during the handler call */
+} ErrorEvent;
+
+/* Receives every reported failure; must be thread-safe */
+typedef void (*ErrorHandler)(const ErrorEvent *event, void *context);
+
+/* A handler and its context, installed together */
+typedef struct ErrorReporter
+{
+    ErrorHandler  handler;
+    void         *context;
+} ErrorReporter;
+
+/* Rule 41: Constants use UPPER_CASE */
+#define ERROR_RECORD_SUBJECT_SIZE 48
+
+/* An ErrorEvent as stored by error_ring_handler(), without formatting */
+typedef struct ErrorRecord
+{
+    ErrorSeverity  severity;
+    int            code;
+    int            sys_errno;
+    int            has_value;
+    long           value;
+    const char    *function;
+    const char    *message;
+    char           subject[ERROR_RECORD_SUBJECT_SIZE];  /* Leading bytes, NUL-terminated */
+} ErrorRecord;
+
+typedef struct ErrorRing ErrorRing;
+
+typedef enum LogLevel
+{
+    LOG_LEVEL_DEBUG   = 0,
+    LOG_LEVEL_INFO    = 1,
+    LOG_LEVEL_WARNING = 2,
+    LOG_LEVEL_ERROR   = 3
+} LogLevel;
+
+typedef struct Logger Logger;
+
+/* ==========================================================================
+ * Error reporting
+ * ========================================================================== */
+
+/**
+ * @brief Route the library's error reports to a handler.
+ *
+ * Every function that fails also reports why (what, where, errno, the path
+ * or value involved) through the installed reporter. The default writes
+ * one line to stderr, which takes the stdio lock and formats on every
+ * failure; error_ring_handler() records the event in a lock-free ring
+ * instead, so error storms do not serialise threads. Installing is a
+ * single atomic store and may happen while other threads report.
+ *
+ * @param reporter Handler and context, or NULL for the stderr default.
+ *                 Must stay valid while installed.
+ */
+void error_reporter_set(const ErrorReporter *reporter);
+
+/**
+ * @brief The default handler: one formatted line on stderr.
+ *
+ * @param event Event to print
+ * @param context Unused
+ */
+void error_handler_stderr(const ErrorEvent *event, void *context);
+
+/**
+ * @brief Create a ring that stores error events without formatting them.
+ *
+ * @param capacity Records held before new ones are dropped (rounded up to
+ *                 a power of two)
+ * @return New ring, or NULL on failure
+ */
+ErrorRing *error_ring_create(size_t capacity);
+
+/**
+ * @brief ErrorHandler that appends the event to the ErrorRing in context.
+ *
+ * Lock-free and never blocks: when the ring is full the event is dropped
+ * and counted. The subject is copied (its first bytes), not formatted.
+ *
+ * @param event Event to record
+ * @param context ErrorRing to record into
+ */
+void error_ring_handler(const ErrorEvent *event, void *context);
+
+/**
+ * @brief Move up to max of the oldest records out of the ring.
+ *
+ * @param ring Ring to drain
+ * @param records Output array of max records
+ * @param max Capacity of records
+ * @return Number of records written (0 if ring or records is NULL)
+ */
+size_t error_ring_drain(ErrorRing *ring, ErrorRecord *records, size_t max);
+
+/**
+ * @brief Number of events dropped because the ring was full.
+ *
+ * @param ring Ring to query
+ * @return Dropped events since creation (0 if ring is NULL)
+ */
+uint64_t error_ring_dropped(const ErrorRing *ring);
+
+/**
+ * @brief Free a ring and clear the caller's pointer.
+ *
+ * Uninstall any reporter that uses the ring first.
+ *
+ * @param ring Pointer to the ring pointer (set to NULL)
+ */
+void error_ring_destroy(ErrorRing **ring);
+
+/* ==========================================================================
+ * Logging
+ * ========================================================================== */
+
+/**
+ * @brief Start a logger that writes to fd from a background thread.
+ *
+ * Log calls store a fixed-size binary record in a lock-free ring and
+ * return; the logger's thread formats records and writes them to fd in
+ * batches, one write() per batch. The caller keeps ownership of fd.
+ *
+ * @param fd Descriptor to write log lines to
+ * @param capacity Records buffered before new ones are dropped, or 0 for
+ *                 the default (4096)
+ * @return New logger, or NULL on failure
+ */
+Logger *logger_create(int fd, size_t capacity);
+
+/**
+ * @brief Log one message; never waits for the logger's thread.
+ *
+ * Takes a timestamp and copies the record (tens of nanoseconds while the
+ * logger is busy). Once the logger's thread has found the ring empty for
+ * a while it goes to sleep, and the first call after that also wakes it:
+ * one futex system call on Linux, a mutex and condition variable signal
+ * elsewhere. When the ring is full the record is dropped and counted.
+ *
+ * @param logger Logger to write to
+ * @param level Severity
+ * @param message Static string; the record keeps the pointer
+ * @param subject Optional detail such as a path (first bytes are copied),
+ *                or NULL
+ * @return ERROR_NONE; ERROR_TRUNCATED if the record was dropped;
+ *         ERROR_NULL_PARAM if logger or message is NULL
+ */
+int logger_log(Logger *logger, LogLevel level, const char *message, const char *subject);
+
+/**
+ * @brief ErrorHandler that logs each event through the Logger in context.
+ *
+ * Install with error_reporter_set() to send the library's own errors to
+ * the logger instead of stderr.
+ *
+ * @param event Event to log
+ * @param context Logger to log to
+ */
+void logger_error_handler(const ErrorEvent *event, void *context);
+
+/**
+ * @brief Wait until everything logged before the call has been written.
+ *
+ * @param logger Logger to flush
+ */
+void logger_flush(Logger *logger);
+
+/**
+ * @brief Records dropped because the ring was full or a write failed.
+ *
+ * @param logger Logger to query
+ * @return Dropped records since creation (0 if logger is NULL)
+ */
+uint64_t logger_dropped(const Logger *logger);
+
+/**
+ * @brief Write out what is buffered, stop the thread and free the logger.
+ *
+ * No other thread may log to it from the moment this is called.
+ *
+ * @param logger Pointer to the logger pointer (set to NULL)
+ */
+void logger_destroy(Logger **logger);
+
+/* ==========================================================================
+ * Strings
+ * ========================================================================== */
+
+/**
+ * @brief Safely copy a string with bounds checking.
+ *
+ * Copies at most dest_size - 1 characters and always NUL-terminates dest.
+ *
+ * @param dest Destination buffer
+ * @param dest_size Size of destination buffer
+ * @param src Source string
+ * @return Number of characters copied, or negative error code on error
+ */
+int safe_string_copy(char *dest, size_t dest_size, const char *src);
+
+/**
+ * @brief Copy a string, bounding all work by the destination size.
+ *
+ * Reads at most dest_size bytes of src, so src need not be terminated
+ * within any larger bound: copying the head of a multi-megabyte untrusted
+ * buffer costs O(dest_size). dest is always NUL-terminated, including when
+ * the copy is truncated.
+ *
+ * @param dest Destination buffer
+ * @param dest_size Size of destination buffer
+ * @param src Source string
+ * @param out_length Optional; receives the number of characters copied
+ * @return ERROR_NONE if all of src fit, ERROR_TRUNCATED if it was cut to
+ *         dest_size - 1 characters, or another negative error code
+ */
+int safe_string_copy_bounded(char *dest, size_t dest_size, const char *src, size_t *out_length);
+
+/**
+ * @brief Copy an array of string fields with one validation pass.
+ *
+ * Every field is validated before any destination is written, so on error
+ * nothing has been copied. Each field is then copied as by
+ * safe_string_copy_bounded(), with the copy kernel chosen once per call.
+ *
+ * @param fields Fields to copy
+ * @param count Number of fields
+ * @param truncated Output bitmask of (count + 63) / 64 words; bit (i % 64)
+ *        of word (i / 64) is set when field i was truncated
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int safe_string_copy_batch(const StringCopyField *fields, size_t count, uint64_t *truncated);
+
+/* ==========================================================================
+ * Files
+ * ========================================================================== */
+
+/**
+ * @brief Read a configuration file safely.
+ *
+ * Reads at most buffer_size - 1 bytes and NUL-terminates buffer.
+ *
+ * @param filename Path to the file
+ * @param buffer Output buffer
+ * @param buffer_size Size of output buffer
+ * @return Bytes read on success, negative error code on failure
+ */
+int read_config_file(const char *filename, char *buffer, size_t buffer_size);
+
+/**
+ * @brief Map a whole configuration file read-only, without copying it.
+ *
+ * On success view->data points at view->size bytes of file content. The
+ * data is not NUL-terminated. It stays valid until unmap_config_file(). An
+ * empty file yields a non-NULL view of size 0. Truncating the file while it
+ * is mapped makes later accesses fault (SIGBUS), as with any mapping.
+ *
+ * @param filename Path to the file
+ * @param view Output view; cleared on failure
+ * @return ERROR_NONE on success; ERROR_FILE_OPEN if the file cannot be
+ *         opened, ERROR_FILE_READ if it is not a regular file or cannot be
+ *         mapped, or another negative error code
+ */
+int map_config_file(const char *filename, ConfigView *view);
+
+/**
+ * @brief Release a view returned by map_config_file() and clear it.
+ *
+ * @param view View to release; NULL or already-released views are ignored
+ */
+void unmap_config_file(ConfigView *view);
+
+/**
+ * @brief Read a configuration file through a process-wide cache.
+ *
+ * Same contract and return codes as read_config_file(). Each call stat()s
+ * the file; while its device, inode, size, mtime and ctime are unchanged
+ * the bytes are copied from memory instead of re-read. Thread-safe; hits
+ * take only a shared lock. Files over 1 MiB are not cached.
+ *
+ * @param filename Path to the file
+ * @param buffer Output buffer
+ * @param buffer_size Size of output buffer
+ * @return Bytes read on success, negative error code on failure
+ */
+int read_config_file_cached(const char *filename, char *buffer, size_t buffer_size);
+
+/**
+ * @brief Drop every file cached by read_config_file_cached().
+ */
+void config_cache_clear(void);
+
+/**
+ * @brief Report read_config_file_cached() hits and misses since the last clear.
+ *
+ * @param hits Optional; receives the hit count
+ * @param misses Optional; receives the miss count
+ */
+void config_cache_stats(uint64_t *hits, uint64_t *misses);
+
+/**
+ * @brief Open a file for reading in fixed-size chunks.
+ *
+ * Memory use is constant: chunks are read straight into the caller's
+ * buffer with no stdio buffer in between.
+ *
+ * @param reader Reader to initialise
+ * @param filename Path to the file
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int config_reader_open(ConfigReader *reader, const char *filename);
+
+/**
+ * @brief Read the next chunk.
+ *
+ * Every chunk but the last fills chunk_size bytes. Chunks are not
+ * NUL-terminated. At end of file *out_length is 0.
+ *
+ * @param reader Open reader
+ * @param chunk Output buffer
+ * @param chunk_size Size of output buffer
+ * @param out_length Receives the number of bytes read
+ * @return ERROR_NONE on success (including end of file), negative error
+ *         code on failure
+ */
+int config_reader_next(ConfigReader *reader, char *chunk, size_t chunk_size, size_t *out_length);
+
+/**
+ * @brief Close a reader and clear it.
+ *
+ * @param reader Reader to close; NULL or closed readers are ignored
+ */
+void config_reader_close(ConfigReader *reader);
+
+/**
+ * @brief Pass a whole file to a callback in fixed-size chunks.
+ *
+ * @param filename Path to the file
+ * @param chunk Scratch buffer the chunks are read into
+ * @param chunk_size Size of the scratch buffer
+ * @param callback Called once per non-empty chunk
+ * @param context Passed through to callback
+ * @param total_bytes Optional; receives the bytes delivered, also on failure
+ * @return ERROR_NONE on success, the callback's negative code if it stopped
+ *         early, or another negative error code
+ */
+int read_config_chunks(const char *filename, char *chunk, size_t chunk_size,
+                       ConfigChunkFn callback, void *context, uint64_t *total_bytes);
+
+/**
+ * @brief Load many files into FileData objects in one call.
+ *
+ * Meant for start-up paths that read thousands of small files. On Linux the
+ * files are opened, read and closed through io_uring in batches; elsewhere,
+ * or when io_uring is unavailable or SAFE_RUNTIME_NO_IO_URING is set in the
+ * environment, a small thread pool loads them. Each FileData holds the
+ * whole file: size is the file length and content is NUL-terminated.
+ *
+ * @param paths Paths to load
+ * @param count Number of paths
+ * @param out_files Receives one FileData per path, NULL where loading
+ *        failed; release each with destroy_file_data()
+ * @param out_status Optional; receives one status per path (ERROR_FILE_OPEN,
+ *        ERROR_FILE_READ, ERROR_MEMORY, ...)
+ * @return ERROR_NONE if every file loaded, otherwise the status of the
+ *         first path that failed
+ */
+int load_config_files(const char *const *paths, size_t count, FileData **out_files,
+                      int *out_status);
+
+/* ==========================================================================
+ * Data processing
+ * ========================================================================== */
+
+/**
+ * @brief Copy input into a scratch buffer and print it to stdout.
+ *
+ * The scratch buffer is a 256-byte stack array, so nothing is allocated;
+ * longer input is cut to its first 255 bytes.
+ *
+ * @param input Input string to process
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int process_data(const char *input);
+
+/**
+ * @brief process_data() with its scratch buffer taken from an arena.
+ *
+ * The arena is rewound before returning, so it does not grow across calls.
+ *
+ * @param arena Arena for the scratch buffer, or NULL to use the heap
+ * @param input Input string to process
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int process_data_in(Arena *arena, const char *input);
+
+/**
+ * @brief Process many inputs, writing their output in large batches.
+ *
+ * Writes the same "Processed: ..." lines as process_data() (long inputs
+ * cut at 255 bytes likewise), but formats them into one buffer and writes
+ * it to fd when it fills and at the end, with no stdio locking. With a
+ * buffer larger than the output, the whole batch takes a single write().
+ * If fd is also used through a FILE such as stdout, flush that first.
+ *
+ * @param fd Descriptor to write to
+ * @param inputs Input strings; NULL entries fail with ERROR_NULL_PARAM
+ * @param count Number of inputs
+ * @param buffer Output buffer, reusable across calls, or NULL for an
+ *        internal 8 KiB one
+ * @param buffer_size Size of buffer (ignored when buffer is NULL)
+ * @param out_status Optional; receives one status per input (ERROR_NONE,
+ *        ERROR_NULL_PARAM, or ERROR_FILE_WRITE if a write holding its
+ *        output failed)
+ * @return ERROR_NONE if every input was written, otherwise the status of the
+ *         first input that failed; ERROR_NULL_PARAM or ERROR_INVALID_INPUT
+ *         for bad arguments
+ */
+int process_data_batch(int fd, const char *const *inputs, size_t count, char *buffer,
+                       size_t buffer_size, int *out_status);
+
+/* ==========================================================================
+ * Conversions
+ * ========================================================================== */
+
+/**
+ * @brief Safely convert a long value to int with overflow check.
+ *
+ * @param large_value Value to convert
+ * @param out_value Output pointer for converted value
+ * @return ERROR_NONE on success, ERROR_OVERFLOW if value out of range
+ */
+int convert_long_to_int(long large_value, int *out_value);
+
+/**
+ * @brief Range-check and narrow an array of long values to int.
+ *
+ * Values are converted in order until the first one outside int's range;
+ * out[0, index) is written and nothing from index on. Nothing is printed.
+ * Vectorised on x86-64, so large arrays convert at memory bandwidth.
+ *
+ * @param values Values to convert
+ * @param out Output array of count ints; either disjoint from values or
+ *            exactly (int *)values to narrow in place
+ * @param count Number of values
+ * @param out_index Optional; receives the index of the first out-of-range
+ *                  value, or count when all fit
+ * @return ERROR_NONE if all values fit, ERROR_OVERFLOW if one did not,
+ *         ERROR_NULL_PARAM for NULL arrays with a non-zero count
+ */
+int convert_long_array_to_int(const long *values, int *out, size_t count, size_t *out_index);
+
+/* ==========================================================================
+ * FileData lifecycle
+ * ========================================================================== */
+
+/**
+ * @brief Allocate a FileData structure with a zeroed content buffer.
+ *
+ * The content comes from calloc(), or for 1 MiB and more from an
+ * anonymous mapping, so it is zero without being cleared by hand and
+ * untouched pages take no memory.
+ *
+ * @param size Size of content buffer to allocate
+ * @return Pointer to allocated structure, or NULL on failure
+ */
+FileData *create_file_data(size_t size);
+
+/**
+ * @brief Allocate a FileData structure, optionally from an arena.
+ *
+ * With an arena both the structure and its content are bump-allocated and
+ * released together when the arena is rewound, reset or destroyed.
+ *
+ * @param arena Arena to allocate from, or NULL for create_file_data()
+ * @param size Size of content buffer to allocate
+ * @return Pointer to allocated structure, or NULL on failure
+ */
+FileData *create_file_data_in(Arena *arena, size_t size);
+
+/**
+ * @brief Allocate an empty FileData to be filled with file_data_append().
+ *
+ * @param capacity Bytes to reserve up front, or 0 for a small default
+ * @return Pointer to a FileData with size 0, or NULL on failure
+ */
+FileData *create_file_data_empty(size_t capacity);
+
+/**
+ * @brief Make room for at least capacity bytes of content.
+ *
+ * Growth at least doubles the capacity, so repeated calls are amortised
+ * O(1) per byte. Content up to size is kept and the rest stays zero; the
+ * content pointer changes when the buffer moves.
+ *
+ * @param data FileData to grow (heap or arena)
+ * @param capacity Minimum capacity wanted
+ * @return ERROR_NONE on success; ERROR_NULL_PARAM for a NULL or destroyed
+ *         FileData; ERROR_MEMORY if the allocation fails
+ */
+int file_data_reserve(FileData *data, size_t capacity);
+
+/**
+ * @brief Append bytes to a FileData, growing it as needed.
+ *
+ * Content stays NUL-terminated at content[size].
+ *
+ * @param data FileData to append to
+ * @param bytes Bytes to append (may be NULL when length is 0)
+ * @param length Number of bytes
+ * @return ERROR_NONE on success; ERROR_NULL_PARAM; ERROR_OVERFLOW if the
+ *         new size does not fit in size_t; ERROR_MEMORY
+ */
+int file_data_append(FileData *data, const void *bytes, size_t length);
+
+/**
+ * @brief Clear and free a FileData structure and all its resources.
+ *
+ * Content is wiped, mapped buffers of 1 MiB and more included (only their
+ * resident pages: untouched pages hold no data), and the caller's pointer
+ * cleared. Heap FileData of up to 64 KiB may be kept in a
+ * per-thread pool for reuse by create_file_data() instead of being freed
+ * (see file_data_pool_trim()).
+ * Arena-allocated FileData returns to the arena on the next rewind, reset
+ * or destroy.
+ *
+ * @param data Pointer to pointer to FileData (set to NULL after free)
+ */
+void destroy_file_data(FileData **data);
+
+/**
+ * @brief Free the FileData objects the calling thread keeps for reuse.
+ *
+ * Happens automatically when a thread exits; call it to return memory
+ * earlier, e.g. after a burst of large allocations.
+ */
+void file_data_pool_trim(void);
+
+/**
+ * @brief Allocate a FileDataInline with size zeroed content bytes.
+ *
+ * Structure and content share one allocation, so creating it costs one
+ * malloc() and the content sits directly after size and valid.
+ *
+ * @param size Size of content buffer to allocate
+ * @return Pointer to allocated structure, or NULL on failure
+ */
+FileDataInline *create_file_data_inline(size_t size);
+
+/**
+ * @brief Clear and free a FileDataInline.
+ *
+ * @param data Pointer to pointer to FileDataInline (set to NULL after free)
+ */
+void destroy_file_data_inline(FileDataInline **data);
+
+/**
+ * @brief Zero memory; the compiler may not optimise the stores away.
+ *
+ * Same guarantee as explicit_bzero(). Buffers of 1 MiB and more are cleared
+ * with non-temporal stores on x86-64, so wiping them does not evict the
+ * cache. Used by every destroy path in this library.
+ *
+ * @param ptr Buffer to wipe (NULL is ignored)
+ * @param size Bytes to wipe
+ */
+void secure_wipe(void *ptr, size_t size);
+
+/* ==========================================================================
+ * Arena allocation
+ * ========================================================================== */
+
+/**
+ * @brief Create an arena for per-request allocations.
+ *
+ * @param block_size Bytes per block, or 0 for the default (4 KiB)
+ * @return New arena, or NULL on failure
+ */
+Arena *arena_create(size_t block_size);
+
+/**
+ * @brief Bump-allocate zeroed, max_align_t-aligned memory.
+ *
+ * @param arena Arena to allocate from
+ * @param size Bytes to allocate (non-zero)
+ * @return Pointer to the memory, or NULL on failure
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * @brief Record the current allocation point of an arena.
+ *
+ * @param arena Arena to mark
+ * @return Mark for arena_rewind()
+ */
+ArenaMark arena_mark(const Arena *arena);
+
+/**
+ * @brief Wipe and release everything allocated since a mark.
+ *
+ * Rewinding to a mark invalidates every mark taken after it.
+ *
+ * @param arena Arena to rewind
+ * @param mark Mark from arena_mark() on the same arena
+ */
+void arena_rewind(Arena *arena, ArenaMark mark);
+
+/**
+ * @brief Wipe and release every allocation, keeping one block for reuse.
+ *
+ * @param arena Arena to reset
+ */
+void arena_reset(Arena *arena);
+
+/**
+ * @brief Free an arena and everything allocated from it.
+ *
+ * @param arena Pointer to the arena pointer (set to NULL)
+ */
+void arena_destroy(Arena **arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAFE_RUNTIME_H */
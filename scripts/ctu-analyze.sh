@@ -0,0 +1,418 @@
+#!/bin/bash
+# =============================================================================
+# Cross-Translation-Unit (CTU) Static Analysis
+# =============================================================================
+# Runs the clang static analyzer with cross-TU function inlining, so checks
+# for Rules 22-24 (null dereference, leaks, use-after-free) can follow calls
+# into functions defined in other source files, e.g. a buffer allocated by
+# create_file_data() in one file and released by destroy_file_data() in
+# another.
+#
+# Usage: ./scripts/ctu-analyze.sh [directory] [options]
+#
+# Arguments:
+#   directory          Project directory containing compile_commands.json
+#                      (default: current directory)
+#   --ctu-dir DIR      Where AST dumps and the definition index are stored
+#                      (default: .cache/ctu)
+#   --jobs N           Number of TUs processed in parallel (default: CPUs)
+#   --import-limit N   Maximum number of TUs imported while analyzing one TU
+#                      (default: 8)
+#   --max-memory MB    Virtual memory limit per clang process in every phase
+#                      (default: none)
+#
+# Phases:
+#   1. Emit one AST dump per TU in compile_commands.json. Dumps are reused
+#      while the compile command and every file the TU depends on are
+#      unchanged.
+#   2. Build the external definition index (externalDefMap.txt) mapping each
+#      function definition to the AST dump that contains it.
+#   3. Analyze every TU in parallel; callee bodies are imported on demand
+#      from the AST dumps, at most --import-limit TUs per analysis.
+#
+# Exit codes:
+#   0 - No critical issues found
+#   1 - Setup error (missing tools or compile_commands.json), or a TU whose
+#       AST dump or analysis failed (compile error, --max-memory exceeded)
+#   2 - Critical issues found
+# =============================================================================
+
+set -e
+
+# -----------------------------------------------------------------------------
+# Configuration
+# -----------------------------------------------------------------------------
+
+# Colors for terminal output
+RED='\033[0;31m'
+YELLOW='\033[0;33m'
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+BOLD='\033[1m'
+NC='\033[0m' # No Color
+
+CLANG="${CLANG:-clang}"
+EXTDEF_MAPPING="${EXTDEF_MAPPING:-clang-extdef-mapping}"
+
+# Analyzer checkers backing Rules 22-24 in rule-severity-mapping.yaml.
+# Findings from these checkers are critical; other analyzer findings warn.
+CRITICAL_CHECKERS="core.NullDereference core.NonNullParamChecker \
+core.StackAddressEscape unix.Malloc unix.MallocSizeof \
+unix.MismatchedDeallocator cplusplus.NewDelete cplusplus.NewDeleteLeaks"
+
+# Parse arguments
+TARGET_DIR="."
+CTU_DIR=""
+JOBS=""
+IMPORT_LIMIT=8
+MAX_MEMORY_MB=""
+
+while [ $# -gt 0 ]; do
+    case $1 in
+        --ctu-dir)
+            CTU_DIR="$2"
+            shift
+            ;;
+        --jobs)
+            JOBS="$2"
+            shift
+            ;;
+        --import-limit)
+            IMPORT_LIMIT="$2"
+            shift
+            ;;
+        --max-memory)
+            MAX_MEMORY_MB="$2"
+            shift
+            ;;
+        *)
+            if [[ -d "$1" ]]; then
+                TARGET_DIR="$1"
+            fi
+            ;;
+    esac
+    shift
+done
+
+if [ -n "$CTU_DIR" ]; then
+    mkdir -p "$CTU_DIR"
+    CTU_DIR="$(cd "$CTU_DIR" && pwd)"
+fi
+cd "$TARGET_DIR"
+PROJECT_DIR="$(pwd)"
+CTU_DIR="${CTU_DIR:-$PROJECT_DIR/.cache/ctu}"
+
+if [ -z "$JOBS" ]; then
+    JOBS=$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 4)
+fi
+
+# -----------------------------------------------------------------------------
+# Functions
+# -----------------------------------------------------------------------------
+
+print_section() {
+    echo ""
+    echo -e "${BOLD}--- $1 ---${NC}"
+    echo ""
+}
+
+print_pass() {
+    echo -e "${GREEN}✓ PASS${NC}: $1"
+}
+
+print_fail() {
+    echo -e "${RED}✗ FAIL${NC}: $1"
+}
+
+print_warn() {
+    echo -e "${YELLOW}⚠ WARN${NC}: $1"
+}
+
+print_info() {
+    echo -e "${BLUE}ℹ INFO${NC}: $1"
+}
+
+# Load the NUL-separated compiler arguments of a TU into ARGS
+read_args() {
+    ARGS=()
+    while IFS= read -r -d '' arg; do
+        ARGS+=("$arg")
+    done < "$CTU_DIR/plan/$1.args"
+}
+
+# Succeeds when the AST dump of a TU is newer than everything it depends on
+# and was produced by the same compile command.
+ast_is_fresh() {
+    local id="$1" dir="$2" digest="$3"
+    local ast="$CTU_DIR/ast/$id.ast"
+
+    [ -f "$ast" ] && [ -f "$ast.d" ] || return 1
+    [ "$(cat "$ast.digest" 2>/dev/null)" = "$digest" ] || return 1
+
+    # Dependency file: "target: dep dep \" continuation lines
+    ! (cd "$dir" && sed -e 's/\\$//' -e 's/^[^:]*://' "$ast.d" | \
+        tr ' ' '\n' | while read -r dep; do
+            if [ -n "$dep" ] && [ "$dep" -nt "$ast" ]; then
+                echo stale
+            fi
+        done | grep -q stale)
+}
+
+# Apply --max-memory to the current (sub)shell and the tools it starts
+limit_memory() {
+    if [ -n "$MAX_MEMORY_MB" ]; then
+        ulimit -v $((MAX_MEMORY_MB * 1024))
+    fi
+}
+
+# Phase 1 worker: "<id>\t<directory>\t<file>\t<digest>"
+emit_ast() {
+    local id dir file digest
+    IFS=$'\t' read -r id dir file digest <<< "$1"
+    local ast="$CTU_DIR/ast/$id.ast"
+
+    if ast_is_fresh "$id" "$dir" "$digest"; then
+        return 0
+    fi
+
+    read_args "$id"
+    rm -f "$CTU_DIR/defs/$id.txt"
+    if (cd "$dir" && limit_memory && "$CLANG" "${ARGS[@]}" -emit-ast \
+            -MD -MF "$ast.d" -o "$ast.tmp" 2> "$ast.log"); then
+        mv "$ast.tmp" "$ast"
+        echo "$digest" > "$ast.digest"
+        echo "emitted"
+    else
+        rm -f "$ast.tmp" "$ast.digest"
+        echo "failed $file"
+    fi
+}
+
+# Phase 2 worker: collect the function definitions of one TU
+map_definitions() {
+    local id dir file digest
+    IFS=$'\t' read -r id dir file digest <<< "$1"
+    local defs="$CTU_DIR/defs/$id.txt"
+
+    if [ -f "$defs" ] || [ ! -f "$CTU_DIR/ast/$id.ast" ]; then
+        return 0
+    fi
+    if (limit_memory && "$EXTDEF_MAPPING" -p "$PROJECT_DIR" "$file") > "$defs.tmp" 2>/dev/null; then
+        mv "$defs.tmp" "$defs"
+    else
+        rm -f "$defs.tmp"
+    fi
+}
+
+# Phase 3 worker: analyze one TU with cross-TU imports enabled
+analyze_tu() {
+    local id dir file digest
+    IFS=$'\t' read -r id dir file digest <<< "$1"
+    local report="$CTU_DIR/reports/$id.txt"
+    local config checkers=() status=0
+
+    config="experimental-enable-naive-ctu-analysis=true"
+    config="$config,ctu-dir=$CTU_DIR,ctu-index-name=externalDefMap.txt"
+    config="$config,ctu-import-threshold=$IMPORT_LIMIT"
+    config="$config,ctu-import-cpp-threshold=$IMPORT_LIMIT"
+
+    for checker in $CRITICAL_CHECKERS; do
+        checkers+=(-Xclang -analyzer-checker="$checker")
+    done
+
+    read_args "$id"
+    (
+        cd "$dir"
+        limit_memory
+        "$CLANG" "${ARGS[@]}" --analyze --analyzer-output text \
+            "${checkers[@]}" \
+            -Xclang -analyzer-config-compatibility-mode=true \
+            -Xclang -analyzer-config -Xclang "$config" \
+            -o /dev/null
+    ) > "$report" 2>&1 || status=$?
+    echo "$status" > "$CTU_DIR/reports/$id.status"
+}
+
+export CTU_DIR CLANG EXTDEF_MAPPING PROJECT_DIR IMPORT_LIMIT MAX_MEMORY_MB \
+       CRITICAL_CHECKERS
+export -f read_args limit_memory ast_is_fresh emit_ast map_definitions analyze_tu
+
+# Run a worker over every TU in the plan, $JOBS at a time
+for_each_tu() {
+    tr '\n' '\0' < "$CTU_DIR/plan/tus.tsv" | \
+        xargs -0 -n 1 -P "$JOBS" bash -c "$1"' "$1"' _
+}
+
+# -----------------------------------------------------------------------------
+# Main Script
+# -----------------------------------------------------------------------------
+
+print_section "Cross-TU analysis"
+
+if [ ! -f compile_commands.json ]; then
+    print_fail "compile_commands.json not found in $PROJECT_DIR"
+    echo "  Run scripts/generate-compile-commands.sh first"
+    exit 1
+fi
+
+for tool in "$CLANG" "$EXTDEF_MAPPING" python3; do
+    if ! command -v "$tool" &> /dev/null; then
+        print_fail "$tool not found (required for cross-TU analysis)"
+        exit 1
+    fi
+done
+
+mkdir -p "$CTU_DIR/plan" "$CTU_DIR/ast" "$CTU_DIR/defs" "$CTU_DIR/reports"
+rm -f "$CTU_DIR"/plan/*.args "$CTU_DIR"/reports/*.txt "$CTU_DIR"/reports/*.status
+
+# Plan: one line per source TU plus its compiler arguments, with the
+# compiler, -c, -o and dependency-file flags removed.
+python3 - compile_commands.json "$CTU_DIR/plan" << 'PYTHON'
+import hashlib
+import json
+import os
+import shlex
+import sys
+
+database_path, plan_dir = sys.argv[1], sys.argv[2]
+SOURCE_EXTENSIONS = (".c", ".cc", ".cpp", ".cxx")
+DROP = {"-c", "-M", "-MM", "-MD", "-MMD", "-MP"}
+DROP_WITH_VALUE = {"-o", "-MF", "-MT", "-MQ"}
+
+with open(database_path, encoding="utf-8") as f:
+    entries = json.load(f)
+
+rows = []
+seen = set()
+for entry in entries:
+    path = os.path.normpath(os.path.join(entry["directory"], entry["file"]))
+    if not path.endswith(SOURCE_EXTENSIONS) or path in seen:
+        continue
+    seen.add(path)
+
+    arguments = entry.get("arguments") or shlex.split(entry["command"])
+    kept = []
+    skip_next = False
+    for arg in arguments[1:]:
+        if skip_next:
+            skip_next = False
+        elif arg in DROP_WITH_VALUE:
+            skip_next = True
+        elif arg in DROP or arg.startswith(("-o", "-MF", "-MT", "-MQ")):
+            continue
+        else:
+            kept.append(arg)
+
+    tu_id = hashlib.sha256(path.encode("utf-8")).hexdigest()[:16]
+    canonical = json.dumps(entry, sort_keys=True, separators=(",", ":"))
+    digest = hashlib.sha256(canonical.encode("utf-8")).hexdigest()
+    with open(os.path.join(plan_dir, tu_id + ".args"), "wb") as out:
+        out.write(b"".join(a.encode("utf-8") + b"\0" for a in kept))
+    rows.append(f"{tu_id}\t{entry['directory']}\t{path}\t{digest}\n")
+
+with open(os.path.join(plan_dir, "tus.tsv"), "w", encoding="utf-8") as out:
+    out.writelines(sorted(rows, key=lambda row: row.split("\t")[2]))
+PYTHON
+
+TU_COUNT=$(wc -l < "$CTU_DIR/plan/tus.tsv" | tr -d ' ')
+if [ "$TU_COUNT" -eq 0 ]; then
+    print_warn "No C/C++ translation units in compile_commands.json"
+    exit 0
+fi
+print_info "$TU_COUNT translation unit(s), $JOBS parallel job(s), import limit $IMPORT_LIMIT"
+
+# Phase 1: AST dumps
+PHASE_LOG="$CTU_DIR/plan/emit.log"
+for_each_tu emit_ast > "$PHASE_LOG"
+EMITTED=$(grep -c '^emitted' "$PHASE_LOG" || true)
+print_info "AST dumps: $EMITTED rebuilt, $((TU_COUNT - EMITTED)) reused"
+grep '^failed ' "$PHASE_LOG" | while read -r _ file; do
+    print_warn "Could not emit AST for $file (see $CTU_DIR/ast/*.log)"
+done
+
+# Phase 2: external definition index. A definition present in several TUs
+# (e.g. the same source compiled twice) is ambiguous and left out.
+for_each_tu map_definitions
+awk '
+    FNR == 1 {
+        id = FILENAME
+        sub(/^.*\//, "", id)
+        sub(/\.txt$/, "", id)
+    }
+    {
+        if (match($0, /^[0-9]+:/)) {
+            length_prefix = substr($0, 1, RLENGTH - 1)
+            usr = substr($0, 1, RLENGTH + length_prefix)
+        } else {
+            usr = $0
+            sub(/ .*$/, "", usr)
+        }
+        if (!(usr in owner)) order[++count] = usr
+        else if (owner[usr] != id) duplicate[usr] = 1
+        owner[usr] = id
+    }
+    END {
+        for (i = 1; i <= count; i++) {
+            if (!(order[i] in duplicate)) print order[i] " ast/" owner[order[i]] ".ast"
+        }
+    }' /dev/null "$CTU_DIR"/defs/*.txt 2>/dev/null | LC_ALL=C sort \
+    > "$CTU_DIR/externalDefMap.txt"
+DEF_COUNT=$(wc -l < "$CTU_DIR/externalDefMap.txt" | tr -d ' ')
+print_info "Indexed $DEF_COUNT external definition(s)"
+
+# Phase 3: analysis
+for_each_tu analyze_tu
+
+CRITICAL_REGEX="\\[($(echo "$CRITICAL_CHECKERS" | tr -s ' ' '|' | sed 's/\./\\./g'))\\]"
+CTU_ERRORS=0
+CTU_WARNINGS=0
+CTU_FAILURES=0
+
+while IFS=$'\t' read -r id dir file digest; do
+    REPORT="$CTU_DIR/reports/$id.txt"
+    STATUS=$(cat "$CTU_DIR/reports/$id.status" 2>/dev/null || echo "missing")
+    DISPLAY="${file#"$PROJECT_DIR"/}"
+    # A TU that could not be analyzed proves nothing; never report it as a pass
+    if grep -Fxq "failed $file" "$PHASE_LOG" || [ "$STATUS" != "0" ] || \
+       grep -q "error:" "$REPORT" 2>/dev/null; then
+        if grep -Fxq "failed $file" "$PHASE_LOG"; then
+            print_fail "$DISPLAY (AST dump failed, see $CTU_DIR/ast/$id.ast.log)"
+        else
+            print_fail "$DISPLAY (analysis failed, exit status $STATUS)"
+        fi
+        grep "error:" "$REPORT" 2>/dev/null | head -3 | while read -r line; do
+            echo "    $line"
+        done
+        CTU_FAILURES=$((CTU_FAILURES + 1))
+    elif grep -E "warning:.*$CRITICAL_REGEX" "$REPORT" > /dev/null 2>&1; then
+        print_fail "$DISPLAY (critical issues)"
+        grep -E "warning:.*$CRITICAL_REGEX" "$REPORT" | head -3 | while read -r line; do
+            echo "    $line"
+        done
+        CTU_ERRORS=$((CTU_ERRORS + 1))
+    elif grep -q "warning:" "$REPORT" 2>/dev/null; then
+        print_warn "$DISPLAY (warnings)"
+        grep "warning:" "$REPORT" | head -3 | while read -r line; do
+            echo "    $line"
+        done
+        CTU_WARNINGS=$((CTU_WARNINGS + 1))
+    else
+        print_pass "$DISPLAY"
+    fi
+done < "$CTU_DIR/plan/tus.tsv"
+
+echo ""
+if [ $CTU_FAILURES -gt 0 ]; then
+    print_fail "$CTU_FAILURES file(s) could not be analyzed"
+fi
+if [ $CTU_ERRORS -gt 0 ]; then
+    print_fail "$CTU_ERRORS file(s) have critical cross-TU issues"
+    exit 2
+elif [ $CTU_FAILURES -gt 0 ]; then
+    exit 1
+elif [ $CTU_WARNINGS -gt 0 ]; then
+    print_warn "$CTU_WARNINGS file(s) have cross-TU warnings (review recommended)"
+else
+    print_pass "No cross-TU issues found"
+fi
+exit 0
@@ -5,15 +5,27 @@
 # This script generates a compile_commands.json file that clangd uses for
 # intelligent code analysis, completion, and navigation.
 #
-# Usage: ./scripts/generate-compile-commands.sh [directory]
+# Usage: ./scripts/generate-compile-commands.sh [directory] [--force] [--symlink]
+#
+# Unknown options print this usage to stderr and exit with status 1.
 #
 # The script supports multiple build systems:
 #   1. CMake (preferred) - if CMakeLists.txt exists
 #   2. Bear - intercepts make/gcc commands
 #   3. Manual generation - creates basic entries for all C/C++ files
 #
+# Entries are written in a stable, sorted order, with a per-entry digest in
+# compile_digests.tsv.
+#
+# Alongside compile_commands.json the script writes include_graph.tsv (see
+# scan-includes.sh) and compile_headers.tsv, mapping every project header to
+# one representative source file that includes it, so headers can be
+# analysed with that file's flags.
+#
 # Arguments:
 #   directory   Target directory to scan (default: current directory)
+#   --force     Reconfigure CMake even if the cached build tree is up to date
+#   --symlink   Symlink build/compile_commands.json instead of copying it
 # =============================================================================
 
 set -e
@@ -30,10 +42,47 @@ NC='\033[0m'
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
 
-# Target directory
-TARGET_DIR="${1:-.}"
+# Parse arguments
+TARGET_DIR="."
+FORCE_MODE=false
+SYMLINK_MODE=false
+
+usage() {
+    echo "Usage: $0 [directory] [--force] [--symlink]" >&2
+    echo "  directory   Target directory to scan (default: current directory)" >&2
+    echo "  --force     Reconfigure CMake even if the cached build tree is up to date" >&2
+    echo "  --symlink   Symlink build/compile_commands.json instead of copying it" >&2
+}
+
+for arg in "$@"; do
+    case $arg in
+        --force)
+            FORCE_MODE=true
+            ;;
+        --symlink)
+            SYMLINK_MODE=true
+            ;;
+        -*)
+            echo "Unknown option: $arg" >&2
+            usage
+            exit 1
+            ;;
+        *)
+            if [[ ! -d "$arg" ]]; then
+                echo "Not a directory: $arg" >&2
+                usage
+                exit 1
+            fi
+            TARGET_DIR="$arg"
+            ;;
+    esac
+done
+
 cd "$TARGET_DIR"
 
+# Stamp recording the configuration that produced build/compile_commands.json
+CMAKE_STAMP="build/.compile-commands.stamp"
+
 print_header() {
     echo ""
     echo -e "${BOLD}${BLUE}======================================================${NC}"
@@ -61,21 +110,93 @@ print_error() {
 # -----------------------------------------------------------------------------
 # Method 1: CMake
 # -----------------------------------------------------------------------------
+hash_stdin() {
+    if command -v sha256sum &> /dev/null; then
+        sha256sum | cut -d' ' -f1
+    else
+        shasum -a 256 | cut -d' ' -f1
+    fi
+}
+
+# Fingerprint of every CMake input plus the CMakeCache of the build tree.
+# Any edit to a CMakeLists.txt, a *.cmake module or a cached option
+# changes the fingerprint and forces a reconfigure. Build trees (any
+# directory below the project holding a CMakeCache.txt, e.g. out/ or
+# cmake-build-debug/) are skipped: their generated *.cmake files change
+# whenever they are reconfigured and are not inputs of this project.
+cmake_fingerprint() {
+    local build_trees
+    build_trees=$(find . -mindepth 2 -type f -name "CMakeCache.txt" \
+        ! -path "*/.git/*" 2>/dev/null | sed 's|CMakeCache\.txt$||')
+    {
+        find . -type f \( -name "CMakeLists.txt" -o -name "*.cmake" \) \
+            ! -path "./build/*" \
+            ! -path "*/.git/*" \
+            ! -path "*/third_party/*" \
+            ! -path "*/vendor/*" \
+            2>/dev/null | \
+            awk -v trees="$build_trees" '
+                BEGIN { count = split(trees, tree, "\n") }
+                {
+                    for (i = 1; i <= count; i++) {
+                        if (substr($0, 1, length(tree[i])) == tree[i]) next
+                    }
+                    print
+                }' | LC_ALL=C sort | while read -r input; do
+                echo "$input $(hash_stdin < "$input")"
+            done
+        echo "CMakeCache.txt $(hash_stdin < build/CMakeCache.txt)"
+    } | hash_stdin
+}
+
+# Database that normalize_database reads; the CMake path points it at the
+# build tree so the copy in the project root is written only on change
+DATABASE_INPUT="compile_commands.json"
+
+# Symlink build/compile_commands.json into the project root, or arrange for
+# normalize_database to copy it there.
+publish_cmake_database() {
+    if $SYMLINK_MODE; then
+        if [ "$(readlink compile_commands.json 2>/dev/null)" != "build/compile_commands.json" ]; then
+            rm -f compile_commands.json
+            ln -s build/compile_commands.json compile_commands.json
+        fi
+    else
+        # A link left by --symlink would redirect the copy into build/
+        if [ -L compile_commands.json ]; then
+            rm -f compile_commands.json
+        fi
+        DATABASE_INPUT="build/compile_commands.json"
+    fi
+}
+
 generate_with_cmake() {
     print_info "CMakeLists.txt found, using CMake..."
-    
+
+    # Reuse an already configured build tree whose inputs are unchanged
+    if ! $FORCE_MODE && \
+       [ -f build/CMakeCache.txt ] && \
+       [ -f build/compile_commands.json ] && \
+       [ -f "$CMAKE_STAMP" ] && \
+       [ "$(cat "$CMAKE_STAMP")" = "$(cmake_fingerprint)" ]; then
+        publish_cmake_database
+        print_success "Reused compile_commands.json from configured build tree"
+        return 0
+    fi
+
     mkdir -p build
     cd build
-    
+
     if cmake -DCMAKE_EXPORT_COMPILE_COMMANDS=ON .. 2>/dev/null; then
         if [ -f compile_commands.json ]; then
-            cp compile_commands.json ../
             cd ..
+            cmake_fingerprint > "$CMAKE_STAMP"
+            publish_cmake_database
             print_success "Generated compile_commands.json using CMake"
             return 0
         fi
     fi
-    
+
     cd ..
     return 1
 }
@@ -122,8 +243,8 @@ generate_manually() {
         ! -path "*/.git/*" \
         ! -path "*/third_party/*" \
         ! -path "*/vendor/*" \
-        2>/dev/null || true)
-    
+        2>/dev/null | LC_ALL=C sort || true)
+
     if [ -z "$FILES" ]; then
         print_warn "No C/C++ source files found"
         return 1
@@ -147,6 +268,13 @@ generate_manually() {
     # Check for common include directories
     [ -d "inc" ] && INCLUDE_FLAGS="$INCLUDE_FLAGS -I./inc"
     [ -d "includes" ] && INCLUDE_FLAGS="$INCLUDE_FLAGS -I./includes"
+
+    # One JSON array element per include flag
+    INCLUDE_ARGS=""
+    for flag in $INCLUDE_FLAGS; do
+        INCLUDE_ARGS="$INCLUDE_ARGS      \"$flag\",
+"
+    done
     
     # Start JSON array
     echo "[" > compile_commands.json
@@ -181,8 +309,7 @@ generate_manually() {
       "$STD",
       "-Wall",
       "-Wextra",
-      $INCLUDE_FLAGS
-      "$ABS_FILE",
+${INCLUDE_ARGS}      "$ABS_FILE",
       "-o",
       "${ABS_FILE%.c*}.o"
     ]
@@ -192,10 +319,7 @@ EOF
     
     echo "" >> compile_commands.json
     echo "]" >> compile_commands.json
-    
-    # Fix the include flags formatting (they need to be separate array elements)
-    # This is a simplified version - proper JSON would split each -I flag
-    
+
     FILE_COUNT=$(echo "$FILES" | wc -l | tr -d ' ')
     print_success "Generated compile_commands.json with $FILE_COUNT entries"
     return 0
@@ -235,6 +359,90 @@ EOF
     print_warn "Edit this file to match your project structure"
 }
 
+# -----------------------------------------------------------------------------
+# Stable database output
+# -----------------------------------------------------------------------------
+# Entry order from find, Bear or CMake depends on traversal or build order.
+# Rewrite compile_commands.json with entries sorted by file (then output)
+# and a fixed layout, and write compile_digests.tsv with a SHA-256 digest of
+# each entry ("<file>\t<digest>"), so caches can invalidate per entry. clang
+# rejects unknown keys in compile_commands.json, hence the separate table.
+# Output goes to a temporary file first and only replaces the existing file
+# when the content differs, so unchanged files keep their mtime.
+DIGEST_TABLE="compile_digests.tsv"
+
+# Move $1 over $2 unless $2 already has the same content
+replace_if_changed() {
+    if [ -f "$2" ] && cmp -s "$1" "$2"; then
+        rm -f "$1"
+    else
+        mv -f "$1" "$2"
+    fi
+}
+
+normalize_database() {
+    # With --symlink the database is written through the link into build/
+    local output="compile_commands.json"
+    if [ -L "$output" ]; then
+        output=$(readlink "$output")
+    fi
+
+    if ! command -v python3 &> /dev/null; then
+        print_warn "python3 not found, compile_commands.json left unsorted"
+        if [ "$DATABASE_INPUT" != "$output" ]; then
+            cp "$DATABASE_INPUT" "$output.tmp"
+            replace_if_changed "$output.tmp" "$output"
+        fi
+        return 0
+    fi
+
+    python3 - "$DATABASE_INPUT" "$output.tmp" "$DIGEST_TABLE.tmp" << 'PYTHON'
+import hashlib
+import json
+import sys
+
+database_path, output_path, digest_path = sys.argv[1], sys.argv[2], sys.argv[3]
+KEY_ORDER = ("directory", "file", "arguments", "command", "output")
+
+with open(database_path, encoding="utf-8") as f:
+    entries = json.load(f)
+
+entries = [{k: e[k] for k in KEY_ORDER if k in e} for e in entries]
+entries.sort(key=lambda e: (e["file"], e.get("output", ""),
+                            json.dumps(e, sort_keys=True)))
+
+digests = []
+for entry in entries:
+    canonical = json.dumps(entry, sort_keys=True, separators=(",", ":"))
+    digest = hashlib.sha256(canonical.encode("utf-8")).hexdigest()
+    digests.append(f"{entry['file']}\t{digest}\n")
+
+with open(output_path, "w", encoding="utf-8") as out:
+    out.write(json.dumps(entries, indent=2) + "\n")
+with open(digest_path, "w", encoding="utf-8") as out:
+    out.write("".join(digests))
+PYTHON
+    replace_if_changed "$output.tmp" "$output"
+    replace_if_changed "$DIGEST_TABLE.tmp" "$DIGEST_TABLE"
+}
+
+# -----------------------------------------------------------------------------
+# Include graph and header-to-TU mapping
+# -----------------------------------------------------------------------------
+# Headers have no entry in compile_commands.json. scan-includes.sh writes the
+# project include graph and, for every header reachable from a source file,
+# the representative translation unit that includes it.
+INCLUDE_GRAPH="include_graph.tsv"
+HEADER_MAP="compile_headers.tsv"
+
+generate_header_map() {
+    if ! "$SCRIPT_DIR/scan-includes.sh" . \
+            --graph "$INCLUDE_GRAPH" \
+            --header-map "$HEADER_MAP"; then
+        print_warn "Include scan failed, $HEADER_MAP not updated"
+    fi
+}
+
 # -----------------------------------------------------------------------------
 # Main
 # -----------------------------------------------------------------------------
@@ -243,19 +451,28 @@ print_header "Generate compile_commands.json"
 print_info "Working directory: $(pwd)"
 print_info "Project root: $PROJECT_ROOT"
 
+# Post-process a successfully generated database
+finalize_database() {
+    normalize_database
+    generate_header_map
+}
+
 # Try methods in order of preference
 if [ -f CMakeLists.txt ]; then
     if generate_with_cmake; then
+        finalize_database
         exit 0
     fi
     print_warn "CMake generation failed, trying alternatives..."
 fi
 
 if generate_with_bear; then
+    finalize_database
     exit 0
 fi
 
 if generate_manually; then
+    finalize_database
     exit 0
 fi
 
@@ -0,0 +1,417 @@
+#!/bin/bash
+# =============================================================================
+# Fast include scanner
+# =============================================================================
+# Extracts the project include graph without running the preprocessor.
+# Each file is lexed for #include directives (comments, string literals and
+# line continuations are honoured, #if 0 / #if 1 branches are resolved, and
+# include guards are recognised). Per-file results are memoised by content
+# hash, so only new or edited files are lexed again, and lexing runs in
+# parallel across the tree.
+#
+# Usage: ./scripts/scan-includes.sh [directory] [options]
+#
+# Arguments:
+#   directory           Target directory to scan (default: current directory)
+#   --graph FILE        Write "<includer>\t<included>" edges to FILE
+#                       (default: include_graph.tsv)
+#   --header-map FILE   Also write "<header>\t<source>" with the first source
+#                       file that includes each header (absolute paths)
+#   --jobs N            Number of parallel lexer processes (default: CPUs)
+#   -I DIR              Additional include directory (repeatable)
+#
+# Output paths in the graph are relative to the scanned directory ("./...").
+# Memoised results live in .cache/include-scan/ under the scanned directory.
+# =============================================================================
+
+set -e
+
+# Colors
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+YELLOW='\033[0;33m'
+NC='\033[0m'
+
+# Bump when the lexer output format changes to invalidate memoised results
+LEXER_VERSION="v2"
+
+# Parse arguments
+TARGET_DIR="."
+GRAPH_FILE="include_graph.tsv"
+HEADER_MAP_FILE=""
+JOBS=""
+SEARCH_DIRS=". include src inc includes"
+
+while [ $# -gt 0 ]; do
+    case $1 in
+        --graph)
+            GRAPH_FILE="$2"
+            shift
+            ;;
+        --header-map)
+            HEADER_MAP_FILE="$2"
+            shift
+            ;;
+        --jobs)
+            JOBS="$2"
+            shift
+            ;;
+        -I)
+            SEARCH_DIRS="$SEARCH_DIRS $2"
+            shift
+            ;;
+        -I*)
+            SEARCH_DIRS="$SEARCH_DIRS ${1#-I}"
+            ;;
+        *)
+            if [[ -d "$1" ]]; then
+                TARGET_DIR="$1"
+            fi
+            ;;
+    esac
+    shift
+done
+
+# Resolve output paths before changing directory
+absolute_output() {
+    case "$1" in
+        /*) echo "$1" ;;
+        *)  echo "$(pwd)/$1" ;;
+    esac
+}
+
+if [ -n "$HEADER_MAP_FILE" ]; then
+    HEADER_MAP_FILE=$(absolute_output "$HEADER_MAP_FILE")
+fi
+cd "$TARGET_DIR"
+GRAPH_FILE=$(absolute_output "$GRAPH_FILE")
+
+if [ -z "$JOBS" ]; then
+    JOBS=$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 4)
+fi
+
+CACHE_DIR=".cache/include-scan/$LEXER_VERSION"
+
+print_info() {
+    echo -e "${BLUE}ℹ INFO${NC}: $1"
+}
+
+print_success() {
+    echo -e "${GREEN}✓ SUCCESS${NC}: $1"
+}
+
+print_warn() {
+    echo -e "${YELLOW}⚠ WARN${NC}: $1"
+}
+
+print_error() {
+    echo -e "${RED}✗ ERROR${NC}: $1"
+}
+
+# -----------------------------------------------------------------------------
+# Lexer
+# -----------------------------------------------------------------------------
+# Invoked as: awk "$LEXER" out=<memo> ./<file> out=<memo> ./<file> ...
+# Writes one record per line to the memo of each file:
+#   include <TAB> q|a <TAB> <spec>   (quoted or angle-bracket include)
+#   guard <TAB> <macro>              (include guard or "#pragma once")
+LEXER='
+function strip(text,    i, n, c, next_char, result, header_done, close_at) {
+    result = ""
+    header_done = 0
+    n = length(text)
+    for (i = 1; i <= n; i++) {
+        c = substr(text, i, 1)
+        next_char = substr(text, i + 1, 1)
+        if (in_comment) {
+            if (c == "*" && next_char == "/") { in_comment = 0; i++; result = result " " }
+            continue
+        }
+        if (in_string) {
+            result = result c
+            if (c == "\\") { result = result next_char; i++ }
+            else if (c == quote) { in_string = 0 }
+            continue
+        }
+        # The header name of an include is copied verbatim: "//" or "/*"
+        # inside "..." or <...> is part of the path, not a comment
+        if (directive_include && !header_done && (c == "\"" || c == "<")) {
+            close_at = index(substr(text, i + 1), (c == "<") ? ">" : "\"")
+            if (close_at > 0) {
+                result = result substr(text, i, close_at + 1)
+                i += close_at
+                header_done = 1
+                continue
+            }
+        }
+        if (c == "/" && next_char == "*") { in_comment = 1; i++; continue }
+        if (c == "/" && next_char == "/") break
+        if ((c == "\"" || c == "\047") && !directive_include) { in_string = 1; quote = c }
+        result = result c
+    }
+    in_string = 0
+    return result
+}
+function dead(    d) {
+    for (d = 1; d <= depth; d++) if (!live[d]) return 1
+    return 0
+}
+# Lex one logical line (continuations already joined) into current
+function lex(line,    name, rest, macro, style) {
+    directive_include = (line ~ /^[ \t]*#[ \t]*(include|include_next|import)[ \t]*[<"]/)
+    if (in_comment || index(line, "/") || index(line, "\"") || index(line, "\047")) {
+        line = strip(line)
+    }
+    if (line !~ /^[ \t]*#/) {
+        if (line ~ /[^ \t]/) seen_code = 1
+        return
+    }
+    sub(/^[ \t]*#[ \t]*/, "", line)
+    name = line
+    sub(/[^a-z_].*$/, "", name)
+    rest = substr(line, length(name) + 1)
+    gsub(/^[ \t]+|[ \t]+$/, "", rest)
+
+    if (name == "if" || name == "ifdef" || name == "ifndef") {
+        depth++
+        kind[depth] = "unknown"
+        live[depth] = 1
+        if (name == "if" && (rest == "0" || rest == "false")) { kind[depth] = "zero"; live[depth] = 0 }
+        if (name == "if" && (rest == "1" || rest == "true")) { kind[depth] = "one" }
+        if (name == "ifndef" && depth == 1 && !seen_code && guard_candidate == "") {
+            guard_candidate = rest
+            guard_depth = depth
+        }
+    } else if (name == "elif" || name == "else") {
+        if (depth > 0) {
+            if (kind[depth] == "zero") { live[depth] = 1; kind[depth] = "unknown" }
+            else if (kind[depth] == "one") { live[depth] = 0 }
+        }
+    } else if (name == "endif") {
+        if (depth > 0) depth--
+    } else if (name == "define") {
+        if (guard_candidate != "" && depth == guard_depth && guard_depth > 0) {
+            macro = rest
+            sub(/[ \t(].*$/, "", macro)
+            if (macro == guard_candidate) print "guard\t" macro > current
+            guard_candidate = "-"
+        }
+    } else if (name == "pragma" && rest == "once") {
+        print "guard\t#pragma once" > current
+    } else if (name == "include" || name == "include_next" || name == "import") {
+        if (!dead() && match(rest, /^("[^"]+"|<[^>]+>)/)) {
+            style = (substr(rest, 1, 1) == "\"") ? "q" : "a"
+            print "include\t" style "\t" substr(rest, 2, RLENGTH - 2) > current
+        }
+    }
+    if (name != "ifndef" && name != "define") seen_code = 1
+}
+FNR == 1 {
+    # A continuation never reaches into the next file: flush the last
+    # logical line of the previous one before switching memo
+    if (pending != "") lex(pending)
+    pending = ""
+    if (current != "") close(current)
+    current = out
+    printf "" > current
+    depth = 0
+    in_comment = 0
+    seen_code = 0
+    guard_candidate = ""
+    guard_depth = 0
+}
+{
+    line = pending $0
+    if (line ~ /\\$/) {
+        pending = substr(line, 1, length(line) - 1)
+        next
+    }
+    pending = ""
+    lex(line)
+}
+END {
+    if (pending != "") lex(pending)
+}
+'
+
+# -----------------------------------------------------------------------------
+# Resolver
+# -----------------------------------------------------------------------------
+# Reads "<hash> <file>" pairs, loads each memo and prints resolved edges.
+# Warns about headers sharing an include guard (the second one is silently
+# empty whenever both are included).
+RESOLVER='
+function normalize(path,    parts, count, i, d, out, result) {
+    count = split(path, parts, "/")
+    d = 0
+    for (i = 1; i <= count; i++) {
+        if (parts[i] == "" || parts[i] == ".") continue
+        if (parts[i] == "..") { if (d > 0) d--; continue }
+        out[++d] = parts[i]
+    }
+    result = "."
+    for (i = 1; i <= d; i++) result = result "/" out[i]
+    return result
+}
+{
+    hash[NR] = $1
+    file[NR] = substr($0, length($1) + 3)
+    known[file[NR]] = 1
+}
+END {
+    ndirs = split(dirs, search, " ")
+    for (n = 1; n <= NR; n++) {
+        memo = cache "/" hash[n]
+        dir = file[n]
+        sub(/\/[^\/]*$/, "", dir)
+        while ((getline record < memo) > 0) {
+            split(record, field, "\t")
+            if (field[1] == "guard") {
+                if (field[2] != "#pragma once" && (field[2] in guard_owner)) {
+                    print "duplicate include guard " field[2] " in " \
+                          guard_owner[field[2]] " and " file[n] > "/dev/stderr"
+                }
+                guard_owner[field[2]] = file[n]
+                continue
+            }
+            target = ""
+            if (field[2] == "q") {
+                candidate = normalize(dir "/" field[3])
+                if (candidate in known) target = candidate
+            }
+            for (i = 1; target == "" && i <= ndirs; i++) {
+                candidate = normalize(search[i] "/" field[3])
+                if (candidate in known) target = candidate
+            }
+            if (target != "") print file[n] "\t" target
+        }
+        close(memo)
+    }
+}
+'
+
+# -----------------------------------------------------------------------------
+# Header map
+# -----------------------------------------------------------------------------
+# For every header reachable from a source file, pick the lexicographically
+# first source that includes it directly or transitively.
+HEADER_MAPPER='
+{ edges[$1] = edges[$1] "\n" $2 }
+$1 ~ /\.(c|cpp|cc|cxx)$/ { sources[$1] = 1 }
+END {
+    for (source in sources) {
+        delete seen
+        head = 1
+        tail = 1
+        queue[1] = source
+        seen[source] = 1
+        while (head <= tail) {
+            count = split(edges[queue[head++]], next_files, "\n")
+            for (i = 2; i <= count; i++) {
+                if (next_files[i] in seen) continue
+                seen[next_files[i]] = 1
+                queue[++tail] = next_files[i]
+                if (next_files[i] ~ /\.(h|hpp|hxx)$/ &&
+                    (!(next_files[i] in owner) || source < owner[next_files[i]])) {
+                    owner[next_files[i]] = source
+                }
+            }
+        }
+    }
+    for (header in owner) {
+        print root substr(header, 2) "\t" root substr(owner[header], 2)
+    }
+}
+'
+
+# -----------------------------------------------------------------------------
+# Main
+# -----------------------------------------------------------------------------
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+find . -type f \( \
+    -name "*.c" -o \
+    -name "*.cpp" -o \
+    -name "*.cc" -o \
+    -name "*.cxx" -o \
+    -name "*.h" -o \
+    -name "*.hpp" -o \
+    -name "*.hxx" \
+    \) \
+    ! -path "*/build/*" \
+    ! -path "*/.git/*" \
+    ! -path "*/.cache/*" \
+    ! -path "*/third_party/*" \
+    ! -path "*/vendor/*" \
+    2>/dev/null | LC_ALL=C sort > "$WORK_DIR/files" || true
+
+if [ ! -s "$WORK_DIR/files" ]; then
+    print_warn "No C/C++ files found"
+    : > "$GRAPH_FILE"
+    [ -n "$HEADER_MAP_FILE" ] && : > "$HEADER_MAP_FILE"
+    exit 0
+fi
+
+mkdir -p "$CACHE_DIR"
+
+# Content hash of every file; the hash names its memo
+tr '\n' '\0' < "$WORK_DIR/files" | xargs -0 -n 256 sh -c \
+    'if command -v sha256sum >/dev/null 2>&1; then sha256sum "$@"; else shasum -a 256 "$@"; fi' _ \
+    > "$WORK_DIR/hashes"
+
+# Lex only files whose memo is missing, in parallel batches. Files with
+# identical content share a memo, so each hash is queued once: two batches
+# never write the same part file. Part files carry this run's PID, so
+# concurrent scans of the same tree do not collide either.
+#
+# awk reads an operand of the form name=value as an assignment, so every
+# path must start with "./" or "/" (find already prints "./...").
+PART=".$$.part"
+awk -v cache="$CACHE_DIR" -v part="$PART" '{
+    memo = cache "/" $1
+    path = substr($0, length($1) + 3)
+    if (!($1 in queued) && (getline probe < memo) < 0) {
+        queued[$1] = 1
+        if (path !~ /^\.?\//) path = "./" path
+        print "out=" memo part
+        print path
+    }
+    close(memo)
+}' "$WORK_DIR/hashes" > "$WORK_DIR/pending"
+
+PENDING=$(( $(wc -l < "$WORK_DIR/pending") / 2 ))
+if [ "$PENDING" -gt 0 ]; then
+    tr '\n' '\0' < "$WORK_DIR/pending" | \
+        xargs -0 -n 128 -P "$JOBS" awk "$LEXER"
+    find "$CACHE_DIR" -name "*$PART" -exec sh -c \
+        'part="$1"; shift; for file; do mv "$file" "${file%"$part"}"; done' _ "$PART" {} +
+
+    # Files without any lines produce no lexer output; memoise them as empty
+    awk -v part="$PART" 'NR % 2 == 1 {
+        memo = substr($0, 5, length($0) - 4 - length(part))
+        if ((getline probe < memo) < 0) printf "" > memo
+        close(memo)
+    }' "$WORK_DIR/pending"
+fi
+
+TOTAL=$(wc -l < "$WORK_DIR/files" | tr -d ' ')
+print_info "Lexed $PENDING of $TOTAL file(s) ($((TOTAL - PENDING)) memoised)"
+
+awk -v cache="$CACHE_DIR" -v dirs="$SEARCH_DIRS" "$RESOLVER" "$WORK_DIR/hashes" \
+    2> "$WORK_DIR/warnings" | LC_ALL=C sort -u > "$GRAPH_FILE"
+
+while read -r warning; do
+    print_warn "$warning"
+done < "$WORK_DIR/warnings"
+
+EDGE_COUNT=$(wc -l < "$GRAPH_FILE" | tr -d ' ')
+print_success "Wrote $EDGE_COUNT include edge(s) to $GRAPH_FILE"
+
+if [ -n "$HEADER_MAP_FILE" ]; then
+    awk -v root="$(pwd)" "$HEADER_MAPPER" "$GRAPH_FILE" | \
+        LC_ALL=C sort > "$HEADER_MAP_FILE"
+    HEADER_COUNT=$(wc -l < "$HEADER_MAP_FILE" | tr -d ' ')
+    print_success "Mapped $HEADER_COUNT header(s) to representative sources in $HEADER_MAP_FILE"
+fi
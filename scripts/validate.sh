@@ -2,11 +2,13 @@
 # =============================================================================
 # Code Standards Validation Script
 # =============================================================================
-# Usage: ./scripts/validate.sh [directory] [--fix]
+# Usage: ./scripts/validate.sh [directory] [--fix] [--ctu]
 #
 # Arguments:
 #   directory   Target directory to validate (default: current directory)
 #   --fix       Apply automatic fixes (formatting only)
+#   --ctu       Also run cross-TU static analysis (scripts/ctu-analyze.sh);
+#               requires compile_commands.json in the target directory
 #
 # Exit codes:
 #   0 - All checks passed
@@ -14,6 +16,8 @@
 #   2 - clang-tidy violations found
 #   3 - Both format and tidy violations found
 #
+# Critical cross-TU findings (--ctu) count as clang-tidy violations.
+#
 # Examples:
 #   ./scripts/validate.sh                    # Check current directory
 #   ./scripts/validate.sh src/               # Check src/ directory
@@ -42,12 +46,16 @@ PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
 # Parse arguments
 TARGET_DIR="."
 FIX_MODE=false
+CTU_MODE=false
 
 for arg in "$@"; do
     case $arg in
         --fix)
             FIX_MODE=true
             ;;
+        --ctu)
+            CTU_MODE=true
+            ;;
         *)
             if [[ -d "$arg" ]]; then
                 TARGET_DIR="$arg"
@@ -99,6 +107,7 @@ print_header "C/C++ Code Standards Validation"
 echo "Configuration:"
 echo "  Target directory: $TARGET_DIR"
 echo "  Fix mode: $FIX_MODE"
+echo "  Cross-TU analysis: $CTU_MODE"
 echo "  Project root: $PROJECT_ROOT"
 
 # Find C/C++ files
@@ -175,22 +184,101 @@ fi
 
 print_section "clang-tidy analysis"
 
-# Only analyze source files (not headers)
+# Source files are analyzed directly; headers are analyzed through the
+# representative source file recorded in compile_headers.tsv (written by
+# generate-compile-commands.sh, or computed here by scan-includes.sh),
+# reporting only diagnostics in the header.
 SOURCE_FILES=$(echo "$FILES" | grep -E '\.(c|cpp|cc|cxx)$' || true)
+HEADER_FILES=$(echo "$FILES" | grep -E '\.(h|hpp|hxx)$' || true)
+
+HEADER_MAP=""
+HEADER_ROOT=""
+for candidate in "$TARGET_DIR/compile_headers.tsv" "./compile_headers.tsv"; do
+    if [ -f "$candidate" ]; then
+        HEADER_MAP="$candidate"
+        HEADER_ROOT=$(cd "$(dirname "$candidate")" && pwd)
+        break
+    fi
+done
+
+absolute_path() {
+    echo "$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+}
+
+# Escape regex metacharacters read from stdin
+regex_escape() {
+    sed 's/[][\.*^$()+?{}|]/\\&/g'
+}
+
+# Print the representative source file for a header, if one is mapped
+representative_source() {
+    if [ -z "$HEADER_MAP" ]; then
+        return 0
+    fi
+    awk -F '\t' -v header="$(absolute_path "$1")" \
+        '$1 == header { print $2; exit }' "$HEADER_MAP"
+}
+
+# Regex matching a header by its path relative to the root the header map
+# was generated in, so same-named headers in other directories are excluded
+header_regex() {
+    local header
+    header=$(absolute_path "$1")
+    case "$header" in
+        "$HEADER_ROOT"/*) echo "(^|/)$(echo "${header#"$HEADER_ROOT"/}" | regex_escape)" ;;
+        *)                echo "^$(echo "$header" | regex_escape)" ;;
+    esac
+}
+
+# Without a generated table, build one from the include graph
+if [ -n "$HEADER_FILES" ] && [ -z "$HEADER_MAP" ]; then
+    SCAN_DIR=$(mktemp -d)
+    trap 'rm -rf "$SCAN_DIR"' EXIT
+    HEADER_MAP="$SCAN_DIR/compile_headers.tsv"
+    HEADER_ROOT=$(cd "$TARGET_DIR" && pwd)
+    if ! "$SCRIPT_DIR/scan-includes.sh" "$TARGET_DIR" \
+            --graph "$SCAN_DIR/include_graph.tsv" \
+            --header-map "$HEADER_MAP" > /dev/null; then
+        print_warn "Include scan failed, skipping headers"
+        HEADER_MAP=""
+    fi
+fi
+
+ANALYSIS_FILES="$SOURCE_FILES"
+if [ -n "$HEADER_FILES" ] && [ -n "$HEADER_MAP" ]; then
+    ANALYSIS_FILES=$(printf '%s\n%s\n' "$SOURCE_FILES" "$HEADER_FILES" | grep -v '^$' || true)
+fi
 
-if [ -z "$SOURCE_FILES" ]; then
+if [ -z "$ANALYSIS_FILES" ]; then
     print_info "No source files to analyze (headers only)"
 else
-    for file in $SOURCE_FILES; do
+    for file in $ANALYSIS_FILES; do
+        TIDY_INPUT="$file"
+        HEADER_REGEX=""
+        if [[ "$file" =~ \.(h|hpp|hxx)$ ]]; then
+            TIDY_INPUT=$(representative_source "$file")
+            if [ -z "$TIDY_INPUT" ]; then
+                print_info "$file (not included by any source file, skipped)"
+                continue
+            fi
+            HEADER_REGEX=$(header_regex "$file")
+        fi
+
         # Run clang-tidy
         OUTPUT=$(clang-tidy \
             --config-file="$PROJECT_ROOT/.clang-tidy" \
-            "$file" \
+            ${HEADER_REGEX:+--header-filter="$HEADER_REGEX\$"} \
+            "$TIDY_INPUT" \
             -- \
             -I"$TARGET_DIR" \
             -I"$PROJECT_ROOT" \
             2>&1 || true)
 
+        # For headers keep only diagnostics located in the header itself
+        if [ -n "$HEADER_REGEX" ]; then
+            OUTPUT=$(echo "$OUTPUT" | grep -E "$HEADER_REGEX:[0-9]+:" || true)
+        fi
+
         # Check for errors (Critical)
         if echo "$OUTPUT" | grep -q "error:"; then
             print_fail "$file (critical issues)"
@@ -227,6 +315,17 @@ else
     fi
 fi
 
+# =============================================================================
+# STEP 3: Cross-TU Static Analysis (optional)
+# =============================================================================
+
+CTU_FAILED=false
+if $CTU_MODE; then
+    if ! "$SCRIPT_DIR/ctu-analyze.sh" "$TARGET_DIR"; then
+        CTU_FAILED=true
+    fi
+fi
+
 # =============================================================================
 # SUMMARY
 # =============================================================================
@@ -245,8 +344,13 @@ else
 fi
 
 # clang-tidy results
-if [ $TIDY_ERRORS -gt 0 ]; then
-    echo -e "${RED}Analysis: $TIDY_ERRORS file(s) have critical issues${NC}"
+if [ $TIDY_ERRORS -gt 0 ] || $CTU_FAILED; then
+    if [ $TIDY_ERRORS -gt 0 ]; then
+        echo -e "${RED}Analysis: $TIDY_ERRORS file(s) have critical issues${NC}"
+    fi
+    if $CTU_FAILED; then
+        echo -e "${RED}Cross-TU: critical issues found (or analysis could not run)${NC}"
+    fi
     if [ $EXIT_CODE -eq 0 ]; then
         EXIT_CODE=2
     else
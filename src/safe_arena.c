@@ -0,0 +1,226 @@
+/**
+ * @file safe_arena.c
+ * @brief Region allocator for per-request allocations.
+ *
+ * An arena is a chain of blocks carved up with a bump pointer. Nothing is
+ * freed individually; arena_rewind() and arena_reset() give back everything
+ * allocated after a point and arena_destroy() frees the lot.
+ *
+ * Free space is always zero: blocks come from calloc() and every byte handed
+ * back is wiped, so arena_alloc() returns zeroed memory (Rule 25) without
+ * clearing it on the hot path, and released data does not linger.
+ *
+ * Rules demonstrated:
+ * - Rule 23: Free all allocated resources
+ * - Rule 24: Prevent use-after-free
+ * - Rule 25: Initialize all variables
+ * - Rule 30: Check size arithmetic for overflow
+ */
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "safe_runtime.h"
+
+/* Rule 41: Constants use UPPER_CASE */
+#define ARENA_DEFAULT_BLOCK 4096u
+#define ARENA_ALIGN         alignof(max_align_t)
+
+typedef struct ArenaBlock
+{
+    struct ArenaBlock *prev;
+    size_t             capacity;
+    size_t             used;
+    alignas(max_align_t) unsigned char data[];
+} ArenaBlock;
+
+struct Arena
+{
+    ArenaBlock *current;
+    size_t      block_size;
+};
+
+/**
+ * @brief Wipe and free one block.
+ */
+static void release_block(ArenaBlock *block)
+{
+    secure_wipe(block->data, block->used);
+    free(block);
+}
+
+/**
+ * @brief Create an arena.
+ *
+ * Rule 20 Compliant: Returns NULL on allocation failure
+ *
+ * @param block_size Bytes per block, or 0 for the default (4 KiB)
+ * @return New arena, or NULL on failure
+ */
+Arena *arena_create(size_t block_size)
+{
+    Arena *arena = malloc(sizeof(*arena));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    /* Rule 25: Initialize all fields; the first block is allocated lazily */
+    arena->current    = NULL;
+    arena->block_size = (block_size != 0) ? block_size : ARENA_DEFAULT_BLOCK;
+    return arena;
+}
+
+/**
+ * @brief Allocate zeroed, max_align_t-aligned memory from an arena.
+ *
+ * Rule 22 Compliant: Validates arguments
+ * Rule 25 Compliant: Memory is zeroed
+ * Rule 30 Compliant: Rounding and block sizing checked for overflow
+ *
+ * @param arena Arena to allocate from
+ * @param size Bytes to allocate (must be non-zero)
+ * @return Pointer to the memory, or NULL on failure
+ */
+void *arena_alloc(Arena *arena, size_t size)
+{
+    /* Rule 22: Validate input */
+    if (arena == NULL || size == 0 || size > SIZE_MAX - ARENA_ALIGN)
+    {
+        return NULL;
+    }
+    size_t rounded = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    ArenaBlock *block = arena->current;
+    if (block == NULL || block->capacity - block->used < rounded)
+    {
+        /* Oversized requests get a block of their own */
+        size_t capacity = (rounded > arena->block_size) ? rounded : arena->block_size;
+
+        /* Rule 30: Header plus payload must not overflow */
+        if (capacity > SIZE_MAX - sizeof(ArenaBlock))
+        {
+            return NULL;
+        }
+        block = calloc(1, sizeof(ArenaBlock) + capacity);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        block->prev     = arena->current;
+        block->capacity = capacity;
+        block->used     = 0;
+        arena->current  = block;
+    }
+
+    void *memory = block->data + block->used;
+    block->used += rounded;
+    return memory;
+}
+
+/**
+ * @brief Release every allocation but keep the first block for reuse.
+ *
+ * Rule 23 Compliant: Later blocks freed
+ * Rule 24 Compliant: Released bytes are wiped
+ *
+ * @param arena Arena to reset
+ */
+void arena_reset(Arena *arena)
+{
+    if (arena == NULL || arena->current == NULL)
+    {
+        return;
+    }
+    while (arena->current->prev != NULL)
+    {
+        ArenaBlock *prev = arena->current->prev;
+
+        release_block(arena->current);
+        arena->current = prev;
+    }
+    secure_wipe(arena->current->data, arena->current->used);
+    arena->current->used = 0;
+}
+
+/**
+ * @brief Record the current allocation point.
+ *
+ * @param arena Arena to mark
+ * @return Mark to pass to arena_rewind() (empty if arena is NULL)
+ */
+ArenaMark arena_mark(const Arena *arena)
+{
+    ArenaMark mark = {NULL, 0};
+
+    if (arena != NULL && arena->current != NULL)
+    {
+        mark.block = arena->current;
+        mark.used  = arena->current->used;
+    }
+    return mark;
+}
+
+/**
+ * @brief Release everything allocated since mark was taken.
+ *
+ * Rule 23 Compliant: Blocks opened after the mark are freed
+ * Rule 24 Compliant: Released bytes are wiped
+ *
+ * @param arena Arena to rewind
+ * @param mark Mark from arena_mark() on the same arena
+ */
+void arena_rewind(Arena *arena, ArenaMark mark)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    /* A mark taken before the first allocation: keep the first block */
+    if (mark.block == NULL)
+    {
+        arena_reset(arena);
+        return;
+    }
+    while (arena->current != NULL && arena->current != mark.block)
+    {
+        ArenaBlock *prev = arena->current->prev;
+
+        release_block(arena->current);
+        arena->current = prev;
+    }
+    if (arena->current != NULL && arena->current->used > mark.used)
+    {
+        secure_wipe(arena->current->data + mark.used, arena->current->used - mark.used);
+        arena->current->used = mark.used;
+    }
+}
+
+/**
+ * @brief Free an arena and everything allocated from it.
+ *
+ * Rule 23 Compliant: All blocks freed
+ * Rule 24 Compliant: Caller's pointer set to NULL
+ *
+ * @param arena Pointer to the arena pointer (set to NULL)
+ */
+void arena_destroy(Arena **arena)
+{
+    if (arena == NULL || *arena == NULL)
+    {
+        return;
+    }
+    while ((*arena)->current != NULL)
+    {
+        ArenaBlock *prev = (*arena)->current->prev;
+
+        release_block((*arena)->current);
+        (*arena)->current = prev;
+    }
+    free(*arena);
+    *arena = NULL;
+}
@@ -0,0 +1,747 @@
+/**
+ * @file safe_batch_load.c
+ * @brief Load many small files into FileData objects at once.
+ *
+ * On Linux with io_uring, files are loaded 64 at a time in four
+ * submissions (open, statx of the opened descriptor, read, close), so N
+ * files cost about 4N / 64 system calls instead of 4N. Files over
+ * RING_READ_CHUNK take one more read submission per chunk. The raw system
+ * call interface is used, so there is no liburing dependency. Where
+ * io_uring is unavailable (not built in, blocked by the kernel or a
+ * seccomp policy, or disabled by setting SAFE_RUNTIME_NO_IO_URING in the
+ * environment), a small thread pool loads the files with ordinary
+ * open/fstat/read/close.
+ *
+ * Rules demonstrated:
+ * - Rule 20: Check all return values
+ * - Rule 23: Free all allocated resources
+ * - Rule 25: Initialize all variables
+ */
+
+/* syscall() and struct statx are GNU extensions */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef SAFE_RUNTIME_HAVE_IO_URING
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
+
+#include "safe_runtime.h"
+
+/* Rule 41: Constants use UPPER_CASE */
+#define FALLBACK_MAX_THREADS 8
+
+/**
+ * @brief Wrap bytes already read into a FileData (content NUL-terminated).
+ */
+static int allocate_file_data(size_t length, FileData **out_file)
+{
+    /* Rule 30: Room for the terminator must not overflow */
+    if (length == SIZE_MAX)
+    {
+        return ERROR_OVERFLOW;
+    }
+    *out_file = create_file_data(length + 1);
+    return (*out_file != NULL) ? ERROR_NONE : ERROR_MEMORY;
+}
+
+/**
+ * @brief Load one file with blocking system calls.
+ *
+ * @param path Path to the file
+ * @param out_file Receives the loaded file, or NULL on failure
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+static int load_file_sync(const char *path, FileData **out_file)
+{
+    *out_file = NULL;
+
+    /* Rule 20: Check open return value */
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return ERROR_FILE_OPEN;
+    }
+
+    struct stat info;
+    int         result = ERROR_FILE_READ;
+
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+    {
+        result = ((uintmax_t)info.st_size >= (uintmax_t)SIZE_MAX)
+                     ? ERROR_OVERFLOW
+                     : allocate_file_data((size_t)info.st_size, out_file);
+    }
+
+    size_t total = 0;
+    while (result == ERROR_NONE && total < (size_t)info.st_size)
+    {
+        ssize_t got = read(fd, (*out_file)->content + total, (size_t)info.st_size - total);
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got < 0)
+        {
+            result = ERROR_FILE_READ;
+        }
+        else if (got == 0)
+        {
+            break;  /* File shrank since fstat() */
+        }
+        else
+        {
+            total += (size_t)got;
+        }
+    }
+
+    /* Rule 23: Close on every path; a close error loses no data here */
+    (void)close(fd);
+
+    if (result != ERROR_NONE)
+    {
+        destroy_file_data(out_file);
+        return result;
+    }
+    (*out_file)->size = total;
+    return ERROR_NONE;
+}
+
+/* Shared state for the fallback thread pool */
+typedef struct LoadJob
+{
+    const char *const *paths;
+    size_t             count;
+    FileData         **files;
+    int               *status;
+    atomic_size_t      next;
+} LoadJob;
+
+static void *load_worker(void *arg)
+{
+    LoadJob *job = arg;
+
+    for (;;)
+    {
+        size_t i = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (i >= job->count)
+        {
+            return NULL;
+        }
+        job->status[i] = load_file_sync(job->paths[i], &job->files[i]);
+    }
+}
+
+/**
+ * @brief Load files on a small thread pool; the caller's thread helps.
+ */
+static void load_with_threads(const char *const *paths, size_t count, FileData **files,
+                              int *status)
+{
+    LoadJob   job = {paths, count, files, status, 0};
+    pthread_t threads[FALLBACK_MAX_THREADS - 1];
+    size_t    started = 0;
+    size_t    wanted  = (count < FALLBACK_MAX_THREADS) ? count : FALLBACK_MAX_THREADS;
+
+    /* Rule 20: A thread that fails to start just leaves more work for the
+     * others */
+    while (started + 1 < wanted &&
+           pthread_create(&threads[started], NULL, load_worker, &job) == 0)
+    {
+        started++;
+    }
+    (void)load_worker(&job);
+    for (size_t i = 0; i < started; i++)
+    {
+        (void)pthread_join(threads[i], NULL);
+    }
+}
+
+#ifdef SAFE_RUNTIME_HAVE_IO_URING
+
+#define RING_ENTRIES 128u
+#define RING_BATCH   (RING_ENTRIES / 2u)  /* Files per batch; cancels need room too */
+
+/* Operation tag in the low bits of each SQE's user_data */
+#define OP_OPEN   0u
+#define OP_STATX  1u
+#define OP_READ   2u
+#define OP_CLOSE  3u
+#define OP_CANCEL 4u
+#define OP_BITS   3u
+
+/* The kernel moves at most about 2 GiB per READ; larger files take several */
+#ifndef RING_READ_CHUNK
+    #define RING_READ_CHUNK (1u << 30)
+#endif
+
+/* Per-file progress through the io_uring pipeline */
+typedef struct RingFile
+{
+    int          fd;
+    int          status;
+    unsigned     in_flight;  /* Bit per OP_* submitted and not yet completed */
+    int          at_eof;     /* A READ returned 0: the file shrank */
+    size_t       size;       /* Bytes expected, from statx */
+    size_t       total;      /* Bytes read so far */
+    struct statx info;
+} RingFile;
+
+/* A mapped submission/completion ring pair */
+typedef struct Ring
+{
+    int                  fd;
+    void                *sq_map;
+    size_t               sq_map_size;
+    void                *cq_map;
+    size_t               cq_map_size;
+    struct io_uring_sqe *sqes;
+    size_t               sqes_size;
+    unsigned            *sq_head;
+    unsigned            *sq_tail;
+    unsigned            *sq_mask;
+    unsigned            *sq_array;
+    unsigned            *cq_head;
+    unsigned            *cq_tail;
+    unsigned            *cq_mask;
+    struct io_uring_cqe *cqes;
+    unsigned             pending;  /* Queued but not yet submitted */
+    RingFile            *files;    /* Current batch */
+    size_t               count;
+    int                  broken;   /* Requests may still be in flight */
+} Ring;
+
+static void ring_close(Ring *ring)
+{
+    if (ring->sqes != NULL)
+    {
+        (void)munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_map != NULL && ring->cq_map != ring->sq_map)
+    {
+        (void)munmap(ring->cq_map, ring->cq_map_size);
+    }
+    if (ring->sq_map != NULL)
+    {
+        (void)munmap(ring->sq_map, ring->sq_map_size);
+    }
+    if (ring->fd >= 0)
+    {
+        (void)close(ring->fd);
+    }
+}
+
+/**
+ * @brief Create and map a ring.
+ *
+ * @return ERROR_NONE, or ERROR_INVALID_INPUT when io_uring (or the 5.6+
+ *         opcodes used here) is unavailable
+ */
+static int ring_open(Ring *ring)
+{
+    struct io_uring_params params;
+
+    memset(ring, 0, sizeof(*ring));
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(SYS_io_uring_setup, RING_ENTRIES, &params);
+    if (ring->fd < 0)
+    {
+        return ERROR_INVALID_INPUT;
+    }
+
+    /* IORING_FEAT_RW_CUR_POS arrived with OPENAT/STATX/READ/CLOSE (5.6) */
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0)
+    {
+        ring_close(ring);
+        return ERROR_INVALID_INPUT;
+    }
+
+    ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+        if (ring->cq_map_size > ring->sq_map_size)
+        {
+            ring->sq_map_size = ring->cq_map_size;
+        }
+        ring->cq_map_size = ring->sq_map_size;
+    }
+
+    ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_map == MAP_FAILED)
+    {
+        ring->sq_map = NULL;
+        ring_close(ring);
+        return ERROR_INVALID_INPUT;
+    }
+    ring->cq_map = ring->sq_map;
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0)
+    {
+        ring->cq_map = mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_map == MAP_FAILED)
+        {
+            ring->cq_map = NULL;
+            ring_close(ring);
+            return ERROR_INVALID_INPUT;
+        }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes      = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+    {
+        ring->sqes = NULL;
+        ring_close(ring);
+        return ERROR_INVALID_INPUT;
+    }
+
+    char *sq = ring->sq_map;
+    char *cq = ring->cq_map;
+
+    ring->sq_head  = (unsigned *)(void *)(sq + params.sq_off.head);
+    ring->sq_tail  = (unsigned *)(void *)(sq + params.sq_off.tail);
+    ring->sq_mask  = (unsigned *)(void *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(void *)(sq + params.sq_off.array);
+    ring->cq_head  = (unsigned *)(void *)(cq + params.cq_off.head);
+    ring->cq_tail  = (unsigned *)(void *)(cq + params.cq_off.tail);
+    ring->cq_mask  = (unsigned *)(void *)(cq + params.cq_off.ring_mask);
+    ring->cqes     = (struct io_uring_cqe *)(void *)(cq + params.cq_off.cqes);
+    return ERROR_NONE;
+}
+
+/**
+ * @brief Queue one SQE; the caller never queues more than RING_ENTRIES.
+ */
+static struct io_uring_sqe *ring_queue(Ring *ring, unsigned op, size_t index)
+{
+    unsigned             tail = *ring->sq_tail + ring->pending;
+    unsigned             slot = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe  = &ring->sqes[slot];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data        = ((uint64_t)index << OP_BITS) | op;
+    ring->sq_array[slot]  = slot;
+    ring->pending++;
+    if (op != OP_CANCEL)
+    {
+        ring->files[index].in_flight |= 1u << op;
+    }
+    return sqe;
+}
+
+/**
+ * @brief Publish queued SQEs to the kernel.
+ *
+ * @return Number of SQEs published
+ */
+static unsigned ring_publish(Ring *ring)
+{
+    unsigned published = ring->pending;
+
+    /* Publish the SQEs before the new tail */
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail + ring->pending, __ATOMIC_RELEASE);
+    ring->pending = 0;
+    return published;
+}
+
+/**
+ * @brief Hand every available completion to its RingFile.
+ *
+ * @return Number of completions consumed
+ */
+static unsigned ring_reap(Ring *ring)
+{
+    unsigned head   = *ring->cq_head;
+    unsigned tail   = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    unsigned reaped = tail - head;
+
+    for (; head != tail; head++)
+    {
+        const struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+        unsigned                   op  = (unsigned)(cqe->user_data & ((1u << OP_BITS) - 1u));
+
+        if (op == OP_CANCEL)
+        {
+            continue;  /* The cancelled request completes on its own */
+        }
+        RingFile *file   = &ring->files[cqe->user_data >> OP_BITS];
+        file->in_flight &= ~(1u << op);
+
+        if (op == OP_OPEN)
+        {
+            file->fd     = (cqe->res >= 0) ? cqe->res : -1;
+            file->status = (cqe->res >= 0) ? file->status : ERROR_FILE_OPEN;
+        }
+        else if (op == OP_STATX && cqe->res < 0 && file->status == ERROR_NONE)
+        {
+            file->status = ERROR_FILE_READ;
+        }
+        else if (op == OP_READ && cqe->res < 0)
+        {
+            file->status = ERROR_FILE_READ;
+        }
+        else if (op == OP_READ)
+        {
+            file->total  += (size_t)cqe->res;
+            file->at_eof  = (cqe->res == 0);
+        }
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+/**
+ * @brief Stop every request of the batch still in the kernel and wait for it.
+ *
+ * Called when io_uring_enter fails part-way. SQEs the kernel has not
+ * consumed are taken back (without SQPOLL it reads the tail only inside
+ * io_uring_enter), every request still in flight gets an ASYNC_CANCEL, and
+ * the ring is drained until all of them have completed. Only then may the
+ * caller close descriptors and free the buffers and statx results. If even
+ * that fails, the ring is marked broken and the caller leaks that memory
+ * rather than free it under the kernel.
+ */
+static void ring_cancel(Ring *ring)
+{
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+    for (unsigned queued = head; queued != *ring->sq_tail; queued++)
+    {
+        uint64_t user_data = ring->sqes[ring->sq_array[queued & *ring->sq_mask]].user_data;
+        unsigned op        = (unsigned)(user_data & ((1u << OP_BITS) - 1u));
+
+        ring->files[user_data >> OP_BITS].in_flight &= ~(1u << op);
+    }
+    __atomic_store_n(ring->sq_tail, head, __ATOMIC_RELEASE);
+    ring->pending = 0;
+
+    /* One cancel per request in flight; at most one per file, so they fit */
+    unsigned remaining = 0;
+    for (size_t i = 0; i < ring->count; i++)
+    {
+        for (unsigned op = OP_OPEN; op <= OP_CLOSE; op++)
+        {
+            if ((ring->files[i].in_flight & (1u << op)) != 0)
+            {
+                struct io_uring_sqe *sqe = ring_queue(ring, OP_CANCEL, i);
+                sqe->opcode              = IORING_OP_ASYNC_CANCEL;
+                sqe->addr                = ((uint64_t)i << OP_BITS) | op;
+                remaining += 2;  /* The cancel and the request it targets */
+            }
+        }
+    }
+
+    unsigned to_submit = ring_publish(ring);
+    while (remaining > 0)
+    {
+        long entered = syscall(SYS_io_uring_enter, ring->fd, to_submit, 1u,
+                               IORING_ENTER_GETEVENTS, NULL, 0);
+        if (entered < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY))
+        {
+            continue;
+        }
+        if (entered < 0)
+        {
+            ring->broken = 1;
+            return;
+        }
+        to_submit -= (unsigned)entered < to_submit ? (unsigned)entered : to_submit;
+
+        unsigned reaped = ring_reap(ring);
+        remaining      -= (reaped < remaining) ? reaped : remaining;
+    }
+}
+
+/**
+ * @brief Submit everything queued and wait for all of it to complete.
+ *
+ * @return ERROR_NONE, or ERROR_FILE_READ if io_uring_enter failed (nothing
+ *         of the batch is left in flight unless the ring is broken)
+ */
+static int ring_run(Ring *ring)
+{
+    unsigned expected  = ring->pending;
+    unsigned to_submit = ring_publish(ring);
+
+    while (expected > 0)
+    {
+        long entered = syscall(SYS_io_uring_enter, ring->fd, to_submit, 1u,
+                               IORING_ENTER_GETEVENTS, NULL, 0);
+        if (entered < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (entered < 0)
+        {
+            ring_cancel(ring);
+            return ERROR_FILE_READ;
+        }
+        to_submit -= (unsigned)entered < to_submit ? (unsigned)entered : to_submit;
+
+        unsigned reaped = ring_reap(ring);
+        expected       -= (reaped < expected) ? reaped : expected;
+    }
+    return ERROR_NONE;
+}
+
+/**
+ * @brief Load one batch of files: open, statx, read, close.
+ */
+static int ring_load_batch(Ring *ring, const char *const *paths, size_t count, FileData **out,
+                           int *status, RingFile *files)
+{
+    ring->files = files;
+    ring->count = count;
+    for (size_t i = 0; i < count; i++)
+    {
+        /* Rule 25: Initialize every field */
+        memset(&files[i], 0, sizeof(files[i]));
+        files[i].fd     = -1;
+        files[i].status = ERROR_NONE;
+
+        struct io_uring_sqe *sqe = ring_queue(ring, OP_OPEN, i);
+        sqe->opcode              = IORING_OP_OPENAT;
+        sqe->fd                  = AT_FDCWD;
+        sqe->addr                = (uint64_t)(uintptr_t)paths[i];
+        sqe->open_flags          = O_RDONLY | O_CLOEXEC;
+    }
+    int result = ring_run(ring);
+
+    /* Stat the opened descriptor, not the path again, so the type and size
+     * belong to the file that is read even if the path is replaced */
+    for (size_t i = 0; i < count && result == ERROR_NONE; i++)
+    {
+        if (files[i].status != ERROR_NONE)
+        {
+            continue;
+        }
+        struct io_uring_sqe *sqe = ring_queue(ring, OP_STATX, i);
+        sqe->opcode              = IORING_OP_STATX;
+        sqe->fd                  = files[i].fd;
+        sqe->addr                = (uint64_t)(uintptr_t)"";
+        sqe->len                 = STATX_TYPE | STATX_SIZE;
+        sqe->off                 = (uint64_t)(uintptr_t)&files[i].info;
+        sqe->statx_flags         = AT_EMPTY_PATH;
+    }
+    if (result == ERROR_NONE)
+    {
+        result = ring_run(ring);
+    }
+
+    for (size_t i = 0; i < count && result == ERROR_NONE; i++)
+    {
+        if (files[i].status != ERROR_NONE)
+        {
+            continue;
+        }
+        if (!S_ISREG(files[i].info.stx_mode))
+        {
+            files[i].status = ERROR_FILE_READ;
+            continue;
+        }
+        if (files[i].info.stx_size >= (uint64_t)SIZE_MAX)
+        {
+            files[i].status = ERROR_OVERFLOW;
+            continue;
+        }
+        files[i].size   = (size_t)files[i].info.stx_size;
+        files[i].status = allocate_file_data(files[i].size, &out[i]);
+    }
+
+    /* Read straight into each FileData until it is full or the file ends
+     * early (it shrank, as the blocking path allows); files larger than
+     * RING_READ_CHUNK take several rounds */
+    while (result == ERROR_NONE)
+    {
+        size_t queued = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (files[i].status != ERROR_NONE || files[i].at_eof || files[i].total == files[i].size)
+            {
+                continue;
+            }
+            size_t left = files[i].size - files[i].total;
+
+            struct io_uring_sqe *sqe = ring_queue(ring, OP_READ, i);
+            sqe->opcode              = IORING_OP_READ;
+            sqe->fd                  = files[i].fd;
+            sqe->addr                = (uint64_t)(uintptr_t)(out[i]->content + files[i].total);
+            sqe->len                 = (uint32_t)((left < RING_READ_CHUNK) ? left : RING_READ_CHUNK);
+            sqe->off                 = (uint64_t)files[i].total;
+            queued++;
+        }
+        if (queued == 0)
+        {
+            break;
+        }
+        result = ring_run(ring);
+    }
+
+    /* Rule 23: Close every descriptor that was opened, through the ring
+     * while it works and directly once it has failed (nothing is in flight
+     * by then) */
+    for (size_t i = 0; i < count; i++)
+    {
+        if (files[i].fd >= 0 && result != ERROR_NONE)
+        {
+            (void)close(files[i].fd);
+        }
+        else if (files[i].fd >= 0)
+        {
+            struct io_uring_sqe *sqe = ring_queue(ring, OP_CLOSE, i);
+            sqe->opcode              = IORING_OP_CLOSE;
+            sqe->fd                  = files[i].fd;
+        }
+    }
+    if (result == ERROR_NONE)
+    {
+        result = ring_run(ring);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        status[i] = (result == ERROR_NONE) ? files[i].status : ERROR_FILE_READ;
+        if (ring->broken)
+        {
+            out[i] = NULL;  /* The kernel may still write to it: leak, never free */
+        }
+        else if (status[i] != ERROR_NONE)
+        {
+            destroy_file_data(&out[i]);  /* Rule 23: No partial results */
+        }
+        else
+        {
+            out[i]->size = files[i].total;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Load all files through io_uring.
+ *
+ * @return ERROR_NONE if the ring could be used, otherwise the caller falls
+ *         back to the thread pool for files not yet loaded
+ */
+static int load_with_io_uring(const char *const *paths, size_t count, FileData **out,
+                              int *status)
+{
+    Ring ring;
+
+    if (getenv("SAFE_RUNTIME_NO_IO_URING") != NULL)
+    {
+        return ERROR_INVALID_INPUT;
+    }
+
+    /* On the heap, so a broken ring can leak it with the buffers */
+    RingFile *files = calloc(RING_BATCH, sizeof(*files));
+    if (files == NULL)
+    {
+        return ERROR_MEMORY;
+    }
+    if (ring_open(&ring) != ERROR_NONE)
+    {
+        free(files);
+        return ERROR_INVALID_INPUT;
+    }
+
+    int result = ERROR_NONE;
+    for (size_t first = 0; first < count && result == ERROR_NONE; first += RING_BATCH)
+    {
+        size_t batch = count - first;
+        batch        = (batch < RING_BATCH) ? batch : RING_BATCH;
+        result       = ring_load_batch(&ring, paths + first, batch, out + first,
+                                       status + first, files);
+    }
+
+    if (!ring.broken)
+    {
+        free(files);
+    }
+    ring_close(&ring);
+    return result;
+}
+
+#endif /* SAFE_RUNTIME_HAVE_IO_URING */
+
+/**
+ * @brief Load many files into FileData objects in one call.
+ *
+ * Rule 20 Compliant: Per-file status reported
+ * Rule 22 Compliant: Null pointers validated
+ * Rule 23 Compliant: Nothing leaked for files that failed
+ *
+ * @param paths Paths to load
+ * @param count Number of paths
+ * @param out_files Receives one FileData per path (NULL where loading failed)
+ * @param out_status Optional; receives one status per path
+ * @return ERROR_NONE if every file loaded, else the first failure's code
+ */
+int load_config_files(const char *const *paths, size_t count, FileData **out_files,
+                      int *out_status)
+{
+    /* Rule 22: Validate input pointers */
+    if ((paths == NULL || out_files == NULL) && count != 0)
+    {
+        return ERROR_NULL_PARAM;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (paths[i] == NULL)
+        {
+            return ERROR_NULL_PARAM;
+        }
+    }
+
+    /* Rule 25: Every output slot starts empty */
+    int *status = (out_status != NULL) ? out_status : calloc(count > 0 ? count : 1, sizeof(int));
+    if (status == NULL)
+    {
+        return ERROR_MEMORY;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        out_files[i] = NULL;
+        status[i]    = ERROR_NONE;
+    }
+
+    int loaded = ERROR_INVALID_INPUT;
+#ifdef SAFE_RUNTIME_HAVE_IO_URING
+    loaded = load_with_io_uring(paths, count, out_files, status);
+#endif
+    if (loaded != ERROR_NONE)
+    {
+        /* The ring is unusable or failed part-way: (re)load what is missing */
+        for (size_t i = 0; i < count; i++)
+        {
+            destroy_file_data(&out_files[i]);
+        }
+        load_with_threads(paths, count, out_files, status);
+    }
+
+    int result = ERROR_NONE;
+    for (size_t i = 0; i < count && result == ERROR_NONE; i++)
+    {
+        result = status[i];
+    }
+    if (status != out_status)
+    {
+        free(status);
+    }
+    return result;
+}
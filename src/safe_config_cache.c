@@ -0,0 +1,353 @@
+/**
+ * @file safe_config_cache.c
+ * @brief Process-wide cache for read_config_file().
+ *
+ * Entries are keyed by path and revalidated on every read with stat():
+ * device, inode, size, mtime and ctime must all match what was cached, or
+ * the file is read again. Hits copy from memory under a shared (read) lock,
+ * so concurrent readers of hot files do not serialise.
+ *
+ * Like any stat-based cache, a rewrite that keeps the size and lands in the
+ * same timestamp tick as the cached version goes unnoticed until the next
+ * change; filesystems with nanosecond timestamps make this unlikely.
+ *
+ * Rules demonstrated:
+ * - Rule 20: Check all return values
+ * - Rule 23: Free all allocated resources
+ * - Rule 25: Initialize all variables
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "safe_runtime.h"
+#include "safe_runtime_internal.h"
+
+/* Rule 41: Constants use UPPER_CASE */
+#define CACHE_ENTRIES       32
+#define CACHE_MAX_FILE_SIZE (1024u * 1024u)
+
+/* The stat() fields that identify one version of a file */
+typedef struct CacheKey
+{
+    dev_t           device;
+    ino_t           inode;
+    off_t           size;
+    struct timespec mtime;
+    struct timespec ctime;
+} CacheKey;
+
+typedef struct CacheEntry
+{
+    char    *path;     /* NULL when the slot is free */
+    uint64_t hash;
+    CacheKey key;
+    char    *content;
+    size_t   size;
+} CacheEntry;
+
+static pthread_rwlock_t g_cache_lock = PTHREAD_RWLOCK_INITIALIZER;
+static CacheEntry       g_cache[CACHE_ENTRIES];
+static size_t           g_cache_next_victim = 0;
+static atomic_ulong     g_cache_hits        = 0;
+static atomic_ulong     g_cache_misses      = 0;
+
+/**
+ * @brief FNV-1a hash of a path, so most lookups skip strcmp().
+ */
+static uint64_t hash_path(const char *path)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (const unsigned char *p = (const unsigned char *)path; *p != '\0'; p++)
+    {
+        hash = (hash ^ *p) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static CacheKey key_from_stat(const struct stat *info)
+{
+    CacheKey key = {info->st_dev, info->st_ino, info->st_size, info->st_mtim, info->st_ctim};
+
+    return key;
+}
+
+static int same_key(const CacheKey *a, const CacheKey *b)
+{
+    return a->device == b->device && a->inode == b->inode && a->size == b->size &&
+           a->mtime.tv_sec == b->mtime.tv_sec && a->mtime.tv_nsec == b->mtime.tv_nsec &&
+           a->ctime.tv_sec == b->ctime.tv_sec && a->ctime.tv_nsec == b->ctime.tv_nsec;
+}
+
+/**
+ * @brief Find the slot for path. Caller holds g_cache_lock.
+ *
+ * @return Matching entry, or NULL
+ */
+static CacheEntry *find_entry(const char *path, uint64_t hash)
+{
+    for (size_t i = 0; i < CACHE_ENTRIES; i++)
+    {
+        if (g_cache[i].path != NULL && g_cache[i].hash == hash &&
+            strcmp(g_cache[i].path, path) == 0)
+        {
+            return &g_cache[i];
+        }
+    }
+    return NULL;
+}
+
+static void release_entry(CacheEntry *entry)
+{
+    /* Config files often hold credentials */
+    secure_wipe(entry->content, entry->size);
+    free(entry->path);
+    free(entry->content);
+    memset(entry, 0, sizeof(*entry));
+}
+
+/**
+ * @brief Copy cached content into the caller's buffer, NUL-terminated.
+ *
+ * @return Bytes copied
+ */
+static int copy_out(const char *content, size_t size, char *buffer, size_t buffer_size)
+{
+    size_t count = (size < buffer_size - 1) ? size : buffer_size - 1;
+
+    memcpy(buffer, content, count);
+    buffer[count] = '\0';
+    return (int)count;
+}
+
+/**
+ * @brief Read the whole file behind fd.
+ *
+ * @param out_content Receives a malloc'd buffer (caller frees)
+ * @param out_size Receives the number of bytes read
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+static int read_whole_file(int fd, size_t expected, char **out_content, size_t *out_size)
+{
+    /* Rule 25: malloc(0) may return NULL; always allocate at least 1 byte */
+    char *content = malloc(expected > 0 ? expected : 1);
+    if (content == NULL)
+    {
+        return ERROR_MEMORY;
+    }
+
+    size_t total = 0;
+    while (total < expected)
+    {
+        ssize_t got = read(fd, content + total, expected - total);
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got < 0)
+        {
+            secure_wipe(content, total);  /* Part of the file was read */
+            free(content);                /* Rule 23: Clean up on error path */
+            return ERROR_FILE_READ;
+        }
+        if (got == 0)
+        {
+            break;  /* File shrank since fstat() */
+        }
+        total += (size_t)got;
+    }
+
+    *out_content = content;
+    *out_size    = total;
+    return ERROR_NONE;
+}
+
+/**
+ * @brief Store a freshly read version of path. Takes ownership of content.
+ */
+static void store_entry(const char *path, uint64_t hash, const CacheKey *key, char *content,
+                        size_t size)
+{
+    char *path_copy = strdup(path);
+    if (path_copy == NULL)
+    {
+        secure_wipe(content, size);
+        free(content);  /* Caching is best effort */
+        return;
+    }
+
+    /* Rule 20: A failed lock means the cache is unusable; just skip it */
+    if (pthread_rwlock_wrlock(&g_cache_lock) != 0)
+    {
+        free(path_copy);
+        secure_wipe(content, size);
+        free(content);
+        return;
+    }
+
+    CacheEntry *entry = find_entry(path, hash);
+    if (entry == NULL)
+    {
+        for (size_t i = 0; i < CACHE_ENTRIES && entry == NULL; i++)
+        {
+            entry = (g_cache[i].path == NULL) ? &g_cache[i] : NULL;
+        }
+    }
+    if (entry == NULL)
+    {
+        /* Full: evict round-robin */
+        entry               = &g_cache[g_cache_next_victim];
+        g_cache_next_victim = (g_cache_next_victim + 1) % CACHE_ENTRIES;
+    }
+    release_entry(entry);
+
+    entry->path    = path_copy;
+    entry->hash    = hash;
+    entry->key     = *key;
+    entry->content = content;
+    entry->size    = size;
+
+    (void)pthread_rwlock_unlock(&g_cache_lock);
+}
+
+/**
+ * @brief Read a configuration file through the process-wide cache.
+ *
+ * Rule 20 Compliant: All return values checked
+ * Rule 22 Compliant: Null pointers validated
+ * Rule 23 Compliant: Descriptor and buffers released on all paths
+ *
+ * @param filename Path to the file
+ * @param buffer Output buffer
+ * @param buffer_size Size of output buffer
+ * @return Bytes copied on success, negative error code on failure
+ */
+int read_config_file_cached(const char *filename, char *buffer, size_t buffer_size)
+{
+    /* Rule 22: Validate input pointers and size exactly as read_config_file */
+    if (filename == NULL || buffer == NULL || buffer_size == 0)
+    {
+        return read_config_file(filename, buffer, buffer_size);
+    }
+
+    /* Rule 20: Missing or unreadable files take the uncached path, which
+     * reports the error */
+    struct stat info;
+    if (stat(filename, &info) != 0 || !S_ISREG(info.st_mode) ||
+        (uintmax_t)info.st_size > CACHE_MAX_FILE_SIZE)
+    {
+        return read_config_file(filename, buffer, buffer_size);
+    }
+
+    uint64_t hash = hash_path(filename);
+    CacheKey key  = key_from_stat(&info);
+
+    /* Hit: copy out under the shared lock */
+    if (pthread_rwlock_rdlock(&g_cache_lock) == 0)
+    {
+        const CacheEntry *entry = find_entry(filename, hash);
+        if (entry != NULL && same_key(&entry->key, &key))
+        {
+            int copied = copy_out(entry->content, entry->size, buffer, buffer_size);
+
+            (void)pthread_rwlock_unlock(&g_cache_lock);
+            atomic_fetch_add_explicit(&g_cache_hits, 1, memory_order_relaxed);
+            return copied;
+        }
+        (void)pthread_rwlock_unlock(&g_cache_lock);
+    }
+    atomic_fetch_add_explicit(&g_cache_misses, 1, memory_order_relaxed);
+
+    /* Miss or stale: read the whole file, keyed by what was opened */
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return read_config_file(filename, buffer, buffer_size);
+    }
+
+    char  *content = NULL;
+    size_t size    = 0;
+    int    result  = ERROR_FILE_READ;
+
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) &&
+        (uintmax_t)info.st_size <= CACHE_MAX_FILE_SIZE)
+    {
+        key    = key_from_stat(&info);
+        result = read_whole_file(fd, (size_t)info.st_size, &content, &size);
+    }
+
+    /* Rule 20: Check close return value */
+    if (close(fd) != 0)
+    {
+        REPORT_WARNING("Failed to close file", filename, errno);
+    }
+
+    if (result != ERROR_NONE)
+    {
+        return read_config_file(filename, buffer, buffer_size);
+    }
+
+    int copied = copy_out(content, size, buffer, buffer_size);
+
+    /* Only cache a read that matches the version fstat() described */
+    if (size == (size_t)info.st_size)
+    {
+        store_entry(filename, hash, &key, content, size);
+    }
+    else
+    {
+        secure_wipe(content, size);
+        free(content);
+    }
+    return copied;
+}
+
+/**
+ * @brief Drop every cached file and reset the statistics.
+ *
+ * Rule 23 Compliant: All cached memory freed
+ */
+void config_cache_clear(void)
+{
+    if (pthread_rwlock_wrlock(&g_cache_lock) != 0)
+    {
+        return;
+    }
+    for (size_t i = 0; i < CACHE_ENTRIES; i++)
+    {
+        release_entry(&g_cache[i]);
+    }
+    g_cache_next_victim = 0;
+    atomic_store(&g_cache_hits, 0);
+    atomic_store(&g_cache_misses, 0);
+    (void)pthread_rwlock_unlock(&g_cache_lock);
+}
+
+/**
+ * @brief Report cache hits and misses since start-up or the last clear.
+ *
+ * @param hits Optional; receives the hit count
+ * @param misses Optional; receives the miss count
+ */
+void config_cache_stats(uint64_t *hits, uint64_t *misses)
+{
+    if (hits != NULL)
+    {
+        *hits = atomic_load_explicit(&g_cache_hits, memory_order_relaxed);
+    }
+    if (misses != NULL)
+    {
+        *misses = atomic_load_explicit(&g_cache_misses, memory_order_relaxed);
+    }
+}
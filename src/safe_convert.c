@@ -0,0 +1,192 @@
+/**
+ * @file safe_convert.c
+ * @brief Range-checked narrowing conversions.
+ *
+ * convert_long_array_to_int() narrows whole arrays. On x86-64 it checks
+ * and packs several values per instruction (AVX2 when the CPU has it, SSE2
+ * otherwise, chosen at run time). A value fits in int exactly when its
+ * upper 32 bits are the sign extension of its lower 32, so each block is
+ * checked with one compare and stored only if every lane passes. A failing
+ * block is redone one value at a time to find the first bad index. Other
+ * targets, or builds with SAFE_RUNTIME_NO_SIMD, use the scalar loop.
+ *
+ * Rules demonstrated:
+ * - Rule 20: Report errors as status codes
+ * - Rule 30: Avoid narrowing conversions
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "safe_runtime.h"
+#include "safe_runtime_internal.h"
+
+/* The vector kernels assume LP64 (not x32, where long is 32 bits) */
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && \
+    LONG_MAX == INT64_MAX && !defined(SAFE_RUNTIME_NO_SIMD)
+    #define SAFE_CONVERT_X86_SIMD 1
+    #include <immintrin.h>
+#else
+    #define SAFE_CONVERT_X86_SIMD 0
+#endif
+
+/* Narrows values[0, count) until the first bad value; returns its index */
+typedef size_t (*NarrowKernel)(const long *values, int *out, size_t count);
+
+/**
+ * @brief Safely convert a long value to int with overflow check.
+ *
+ * Rule 30 Compliant: Checks for overflow before narrowing
+ *
+ * @param large_value Value to convert
+ * @param out_value Output pointer for converted value
+ * @return ERROR_NONE on success, ERROR_OVERFLOW if value out of range
+ */
+int convert_long_to_int(long large_value, int *out_value)
+{
+    /* Rule 22: Validate output pointer */
+    if (out_value == NULL)
+    {
+        return ERROR_NULL_PARAM;
+    }
+
+    /* Rule 30: Check for overflow before narrowing */
+    if (large_value > INT_MAX || large_value < INT_MIN)
+    {
+        ErrorEvent event = {ERROR_SEVERITY_ERROR, ERROR_OVERFLOW, 0, 1, large_value,
+                            __func__, "Value out of int range:", NULL};
+        report_event(&event);
+        return ERROR_OVERFLOW;
+    }
+
+    /* Safe to cast after validation */
+    *out_value = (int)large_value;
+    return ERROR_NONE;
+}
+
+/**
+ * @brief Scalar narrowing loop, also used to finish and to redo blocks.
+ *
+ * Loads and stores go through memcpy() so that in-place use (out aliasing
+ * values) is well defined; compilers turn them into plain moves.
+ */
+static size_t narrow_scalar(const long *values, int *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        long value;
+
+        memcpy(&value, &values[i], sizeof(value));
+        if (value > INT_MAX || value < INT_MIN)
+        {
+            return i;
+        }
+        int narrowed = (int)value;
+        memcpy(&out[i], &narrowed, sizeof(narrowed));
+    }
+    return count;
+}
+
+#if SAFE_CONVERT_X86_SIMD
+
+/**
+ * @brief Four values per iteration with SSE2.
+ *
+ * SSE2 has no 64-bit compare, so the check is done on 32-bit halves: the
+ * high half must equal the low half shifted arithmetically by 31.
+ */
+static size_t narrow_sse2(const long *values, int *out, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(const void *)&values[i]));
+        __m128 b = _mm_castsi128_ps(
+            _mm_loadu_si128((const __m128i *)(const void *)&values[i + 2]));
+        __m128i low  = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i high = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        __m128i ok   = _mm_cmpeq_epi32(high, _mm_srai_epi32(low, 31));
+
+        if (_mm_movemask_epi8(ok) != 0xFFFF)
+        {
+            break;
+        }
+        _mm_storeu_si128((__m128i *)(void *)&out[i], low);
+    }
+    return i + narrow_scalar(values + i, out + i, count - i);
+}
+
+/**
+ * @brief Eight values per iteration with AVX2.
+ *
+ * Packs the low halves, sign-extends them back and compares with the input.
+ */
+__attribute__((target("avx2")))
+static size_t narrow_avx2(const long *values, int *out, size_t count)
+{
+    const __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    size_t        i    = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(const void *)&values[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)(const void *)&values[i + 4]);
+        __m128i low_a = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(a, pack));
+        __m128i low_b = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(b, pack));
+        __m256i ok    = _mm256_and_si256(_mm256_cmpeq_epi64(_mm256_cvtepi32_epi64(low_a), a),
+                                         _mm256_cmpeq_epi64(_mm256_cvtepi32_epi64(low_b), b));
+
+        if (_mm256_movemask_epi8(ok) != -1)
+        {
+            break;
+        }
+        _mm256_storeu_si256((__m256i *)(void *)&out[i], _mm256_set_m128i(low_b, low_a));
+    }
+    return i + narrow_scalar(values + i, out + i, count - i);
+}
+
+static NarrowKernel select_narrow(void)
+{
+    return __builtin_cpu_supports("avx2") ? narrow_avx2 : narrow_sse2;
+}
+
+#else /* !SAFE_CONVERT_X86_SIMD */
+
+static NarrowKernel select_narrow(void)
+{
+    return narrow_scalar;
+}
+
+#endif /* SAFE_CONVERT_X86_SIMD */
+
+/**
+ * @brief Range-check and narrow an array of long values to int.
+ *
+ * Rule 20 Compliant: Reports the first bad index instead of printing
+ * Rule 22 Compliant: Validates pointers
+ * Rule 30 Compliant: Every value checked before narrowing
+ *
+ * @param values Values to convert
+ * @param out Output array of count ints; may be (int *)values for in place
+ * @param count Number of values
+ * @param out_index Optional; receives the first out-of-range index, or count
+ * @return ERROR_NONE if all values fit, ERROR_OVERFLOW otherwise
+ */
+int convert_long_array_to_int(const long *values, int *out, size_t count, size_t *out_index)
+{
+    /* Rule 22: Validate pointers (empty arrays may be NULL) */
+    if (count != 0 && (values == NULL || out == NULL))
+    {
+        return ERROR_NULL_PARAM;
+    }
+
+    size_t done = (count != 0) ? select_narrow()(values, out, count) : 0;
+
+    if (out_index != NULL)
+    {
+        *out_index = done;
+    }
+    return (done == count) ? ERROR_NONE : ERROR_OVERFLOW;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file safe_error.c
+ * @brief Pluggable error reporting.
+ *
+ * Library functions report failures as structured ErrorEvents instead of
+ * calling fprintf() themselves. The installed ErrorReporter is read with
+ * one atomic load per report; with none installed the stderr handler
+ * prints the same kind of line the library always printed.
+ *
+ * error_ring_handler() is the alternative for hot error paths: it copies
+ * the event into a lock-free RecordRing (no formatting, no stdio lock) for
+ * a consumer to drain later.
+ *
+ * Rules demonstrated:
+ * - Rule 20: Report errors through one checked channel
+ * - Rule 22: Prevent null pointer dereference
+ * - Rule 23: Free all allocated resources
+ */
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "safe_runtime.h"
+#include "safe_runtime_internal.h"
+
+struct ErrorRing
+{
+    RecordRing *records;
+};
+
+/* NULL selects error_handler_stderr() */
+static _Atomic(const ErrorReporter *) g_reporter = NULL;
+
+/**
+ * @brief Install a reporter, or NULL for the stderr default.
+ *
+ * @param reporter Handler and context; must outlive its installation
+ */
+void error_reporter_set(const ErrorReporter *reporter)
+{
+    atomic_store_explicit(&g_reporter, reporter, memory_order_release);
+}
+
+/**
+ * @brief Print an event as one line on stderr.
+ *
+ * Rule 22 Compliant: NULL fields are printed as placeholders
+ *
+ * @param event Event to print
+ * @param context Unused
+ */
+void error_handler_stderr(const ErrorEvent *event, void *context)
+{
+    (void)context;
+
+    /* Rule 22: Validate input */
+    if (event == NULL)
+    {
+        return;
+    }
+
+    /* One fprintf() per line, so concurrent reports do not interleave */
+    const char *severity = (event->severity == ERROR_SEVERITY_WARNING) ? "Warning" : "Error";
+    const char *function = (event->function != NULL) ? event->function : "?";
+    const char *message  = (event->message != NULL) ? event->message : "failed";
+    const char *quote    = (event->subject != NULL) ? " '" : "";
+    const char *subject  = (event->subject != NULL) ? event->subject : "";
+    const char *unquote  = (event->subject != NULL) ? "'" : "";
+    const char *reason   = (event->sys_errno != 0) ? strerror(event->sys_errno) : NULL;
+
+    if (event->has_value)
+    {
+        fprintf(stderr, "%s: %s: %s%s%s%s %ld%s%s\n", severity, function, message, quote,
+                subject, unquote, event->value, reason != NULL ? ": " : "",
+                reason != NULL ? reason : "");
+    }
+    else
+    {
+        fprintf(stderr, "%s: %s: %s%s%s%s%s%s\n", severity, function, message, quote, subject,
+                unquote, reason != NULL ? ": " : "", reason != NULL ? reason : "");
+    }
+}
+
+/* See safe_runtime_internal.h */
+void report_event(const ErrorEvent *event)
+{
+    /* Handlers may call into libc; callers still expect their errno */
+    int saved_errno = errno;
+
+    const ErrorReporter *reporter = atomic_load_explicit(&g_reporter, memory_order_acquire);
+    if (reporter != NULL && reporter->handler != NULL)
+    {
+        reporter->handler(event, reporter->context);
+    }
+    else
+    {
+        error_handler_stderr(event, NULL);
+    }
+    errno = saved_errno;
+}
+
+void report_error(ErrorSeverity severity, int code, const char *function, const char *message,
+                  const char *subject, int sys_errno)
+{
+    ErrorEvent event = {severity, code, sys_errno, 0, 0, function, message, subject};
+
+    report_event(&event);
+}
+
+/**
+ * @brief Create a ring that stores error events without formatting them.
+ *
+ * Rule 20 Compliant: Returns NULL on allocation failure
+ *
+ * @param capacity Records held before new ones are dropped
+ * @return New ring, or NULL on failure
+ */
+ErrorRing *error_ring_create(size_t capacity)
+{
+    ErrorRing *ring = malloc(sizeof(*ring));
+    if (ring == NULL)
+    {
+        return NULL;
+    }
+    ring->records = record_ring_create(capacity, sizeof(ErrorRecord));
+    if (ring->records == NULL)
+    {
+        free(ring);  /* Rule 23: Clean up partial allocation */
+        return NULL;
+    }
+    return ring;
+}
+
+/**
+ * @brief Record an event in the ring passed as context.
+ *
+ * Rule 21 Compliant: Subject copy bounded by the record
+ * Rule 22 Compliant: NULL ring or event ignored
+ *
+ * @param event Event to record
+ * @param context ErrorRing to record into
+ */
+void error_ring_handler(const ErrorEvent *event, void *context)
+{
+    ErrorRing *ring = context;
+
+    if (event == NULL || ring == NULL)
+    {
+        return;
+    }
+
+    /* Rule 25: Initialize every field, padding included */
+    ErrorRecord record;
+    memset(&record, 0, sizeof(record));
+    record.severity  = event->severity;
+    record.code      = event->code;
+    record.sys_errno = event->sys_errno;
+    record.has_value = event->has_value;
+    record.value     = event->value;
+    record.function  = event->function;
+    record.message   = event->message;
+    if (event->subject != NULL)
+    {
+        (void)safe_string_copy_kernel(record.subject, event->subject,
+                                      sizeof(record.subject) - 1);
+    }
+
+    (void)record_ring_push(ring->records, &record);  /* Full: counted as dropped */
+}
+
+/**
+ * @brief Move up to max of the oldest records out of the ring.
+ *
+ * @param ring Ring to drain
+ * @param records Output array of max records
+ * @param max Capacity of records
+ * @return Number of records written
+ */
+size_t error_ring_drain(ErrorRing *ring, ErrorRecord *records, size_t max)
+{
+    /* Rule 22: Validate input */
+    if (ring == NULL || records == NULL)
+    {
+        return 0;
+    }
+    return record_ring_pop(ring->records, records, max);
+}
+
+/**
+ * @brief Number of events dropped because the ring was full.
+ */
+uint64_t error_ring_dropped(const ErrorRing *ring)
+{
+    return (ring != NULL) ? record_ring_dropped(ring->records) : 0;
+}
+
+/**
+ * @brief Free a ring.
+ *
+ * Rule 23 Compliant: Ring storage freed
+ * Rule 24 Compliant: Caller's pointer set to NULL
+ *
+ * @param ring Pointer to the ring pointer (set to NULL)
+ */
+void error_ring_destroy(ErrorRing **ring)
+{
+    if (ring == NULL || *ring == NULL)
+    {
+        return;
+    }
+    record_ring_destroy(&(*ring)->records);
+    free(*ring);
+    *ring = NULL;  /* Rule 24 */
+}
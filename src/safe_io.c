@@ -0,0 +1,364 @@
+/**
+ * @file safe_io.c
+ * @brief Checked configuration file reading.
+ *
+ * read_config_file() copies into a caller buffer; map_config_file() maps the
+ * whole file read-only instead, so large files are neither copied nor
+ * truncated. config_reader_*() and read_config_chunks() stream a file of any
+ * size through a fixed caller buffer.
+ *
+ * Rules demonstrated:
+ * - Rule 20: Check all return values
+ * - Rule 23: Free all allocated resources
+ * - Rule 24: Clear handles after release
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "safe_runtime.h"
+#include "safe_runtime_internal.h"
+
+/**
+ * @brief Read a configuration file safely.
+ *
+ * Rule 20 Compliant: All return values checked
+ * Rule 22 Compliant: Null pointers validated
+ * Rule 23 Compliant: Resources properly freed on all paths
+ *
+ * @param filename Path to the file
+ * @param buffer Output buffer
+ * @param buffer_size Size of output buffer
+ * @return Bytes read on success, negative error code on failure
+ */
+int read_config_file(const char *filename, char *buffer, size_t buffer_size)
+{
+    /* Rule 22: Validate input pointers */
+    if (filename == NULL || buffer == NULL)
+    {
+        REPORT_ERROR(ERROR_NULL_PARAM, "NULL parameter", NULL, 0);
+        return ERROR_NULL_PARAM;
+    }
+
+    /* Rule 22: Validate buffer size */
+    if (buffer_size == 0)
+    {
+        REPORT_ERROR(ERROR_INVALID_INPUT, "Buffer size is zero", NULL, 0);
+        return ERROR_INVALID_INPUT;
+    }
+
+    /* Rule 20: Check fopen return value */
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        REPORT_ERROR(ERROR_FILE_OPEN, "Cannot open file", filename, errno);
+        return ERROR_FILE_OPEN;
+    }
+
+    /* Rule 20: Check fread return value */
+    size_t bytes_read = fread(buffer, 1, buffer_size - 1, file);
+
+    /* Rule 20: Check for read errors */
+    if (ferror(file))
+    {
+        REPORT_ERROR(ERROR_FILE_READ, "Read failed for", filename, errno);
+        fclose(file);  /* Rule 23: Clean up on error path */
+        return ERROR_FILE_READ;
+    }
+
+    /* Rule 21: Ensure null termination */
+    buffer[bytes_read] = '\0';
+
+    /* Rule 23: Close file handle */
+    /* Rule 20: Check fclose return value */
+    if (fclose(file) != 0)
+    {
+        REPORT_WARNING("Failed to close file", filename, errno);
+        /* Non-fatal, continue with data we read */
+    }
+
+    return (int)bytes_read;
+}
+
+/**
+ * @brief Map a configuration file read-only.
+ *
+ * Rule 20 Compliant: All return values checked
+ * Rule 22 Compliant: Null pointers validated
+ * Rule 23 Compliant: Descriptor closed on all paths
+ *
+ * @param filename Path to the file
+ * @param view Output view; cleared on failure
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int map_config_file(const char *filename, ConfigView *view)
+{
+    /* Rule 22: Validate input pointers */
+    if (filename == NULL || view == NULL)
+    {
+        REPORT_ERROR(ERROR_NULL_PARAM, "NULL parameter", NULL, 0);
+        return ERROR_NULL_PARAM;
+    }
+    view->data = NULL;
+    view->size = 0;
+
+    /* Rule 20: Check open return value */
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        REPORT_ERROR(ERROR_FILE_OPEN, "Cannot open file", filename, errno);
+        return ERROR_FILE_OPEN;
+    }
+
+    /* Rule 20: Check fstat return value */
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        REPORT_ERROR(ERROR_FILE_READ, "Cannot stat file", filename, errno);
+        (void)close(fd);  /* Rule 23: Clean up on error path */
+        return ERROR_FILE_READ;
+    }
+
+    /* Only regular files can be mapped */
+    if (!S_ISREG(info.st_mode))
+    {
+        REPORT_ERROR(ERROR_FILE_READ, "Not a regular file", filename, 0);
+        (void)close(fd);
+        return ERROR_FILE_READ;
+    }
+
+    /* Rule 30: File size must fit the address space */
+    if ((uintmax_t)info.st_size > (uintmax_t)SIZE_MAX)
+    {
+        REPORT_ERROR(ERROR_OVERFLOW, "Too large to map", filename, 0);
+        (void)close(fd);
+        return ERROR_OVERFLOW;
+    }
+    size_t size = (size_t)info.st_size;
+
+    /* mmap() rejects zero-length mappings; an empty file is an empty view */
+    if (size == 0)
+    {
+        (void)close(fd);
+        view->data = "";
+        return ERROR_NONE;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    /* The mapping holds its own reference; the descriptor is not needed */
+    if (close(fd) != 0)
+    {
+        REPORT_WARNING("Failed to close file", filename, errno);
+    }
+
+    /* Rule 20: Check mmap return value */
+    if (map == MAP_FAILED)
+    {
+        REPORT_ERROR(ERROR_FILE_READ, "Cannot map", filename, errno);
+        return ERROR_FILE_READ;
+    }
+
+    view->data = map;
+    view->size = size;
+    return ERROR_NONE;
+}
+
+/**
+ * @brief Release a view returned by map_config_file().
+ *
+ * Rule 22 Compliant: NULL and already-released views are ignored
+ * Rule 24 Compliant: View cleared after release
+ *
+ * @param view View to release
+ */
+void unmap_config_file(ConfigView *view)
+{
+    if (view == NULL)
+    {
+        return;
+    }
+    if (view->data != NULL && view->size != 0)
+    {
+        /* Rule 20: munmap only fails for arguments map_config_file never
+         * produces, so there is nothing to recover */
+        (void)munmap((void *)(uintptr_t)view->data, view->size);
+    }
+    view->data = NULL;
+    view->size = 0;
+}
+
+/**
+ * @brief Open a file for reading in fixed-size chunks.
+ *
+ * Rule 20 Compliant: All return values checked
+ * Rule 22 Compliant: Null pointers validated
+ *
+ * @param reader Reader to initialise
+ * @param filename Path to the file
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int config_reader_open(ConfigReader *reader, const char *filename)
+{
+    /* Rule 22: Validate input pointers (reader first, so it is always
+     * left closed on failure) */
+    if (reader == NULL)
+    {
+        REPORT_ERROR(ERROR_NULL_PARAM, "NULL parameter", NULL, 0);
+        return ERROR_NULL_PARAM;
+    }
+    reader->file  = NULL;
+    reader->total = 0;
+    if (filename == NULL)
+    {
+        REPORT_ERROR(ERROR_NULL_PARAM, "NULL parameter", NULL, 0);
+        return ERROR_NULL_PARAM;
+    }
+
+    /* Rule 20: Check fopen return value */
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        REPORT_ERROR(ERROR_FILE_OPEN, "Cannot open file", filename, errno);
+        return ERROR_FILE_OPEN;
+    }
+
+    /* Read straight into the caller's chunk buffer */
+    if (setvbuf(file, NULL, _IONBF, 0) != 0)
+    {
+        REPORT_WARNING("Cannot disable buffering for", filename, 0);
+        /* Non-fatal, reads still work through the stdio buffer */
+    }
+
+    reader->file = file;
+    return ERROR_NONE;
+}
+
+/**
+ * @brief Read the next chunk.
+ *
+ * Rule 20 Compliant: Read errors reported
+ * Rule 22 Compliant: Null pointers validated
+ *
+ * @param reader Open reader
+ * @param chunk Output buffer
+ * @param chunk_size Size of output buffer
+ * @param out_length Receives the number of bytes read (0 at end of file)
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int config_reader_next(ConfigReader *reader, char *chunk, size_t chunk_size, size_t *out_length)
+{
+    /* Rule 22: Validate input pointers */
+    if (reader == NULL || reader->file == NULL || chunk == NULL || out_length == NULL)
+    {
+        return ERROR_NULL_PARAM;
+    }
+    *out_length = 0;
+
+    /* Rule 22: Validate buffer size */
+    if (chunk_size == 0)
+    {
+        return ERROR_INVALID_INPUT;
+    }
+
+    /* Rule 20: Check fread result and stream error state */
+    size_t bytes_read = fread(chunk, 1, chunk_size, (FILE *)reader->file);
+    if (ferror((FILE *)reader->file))
+    {
+        REPORT_ERROR(ERROR_FILE_READ, "Read failed", NULL, errno);
+        return ERROR_FILE_READ;
+    }
+
+    reader->total += bytes_read;
+    *out_length    = bytes_read;
+    return ERROR_NONE;
+}
+
+/**
+ * @brief Close a reader and clear it.
+ *
+ * Rule 23 Compliant: File handle released
+ * Rule 24 Compliant: Handle cleared after release
+ *
+ * @param reader Reader to close
+ */
+void config_reader_close(ConfigReader *reader)
+{
+    if (reader == NULL || reader->file == NULL)
+    {
+        return;
+    }
+
+    /* Rule 20: Check fclose return value */
+    if (fclose((FILE *)reader->file) != 0)
+    {
+        REPORT_WARNING("Failed to close reader", NULL, errno);
+    }
+    reader->file = NULL;
+}
+
+/**
+ * @brief Pass a whole file to a callback in fixed-size chunks.
+ *
+ * Rule 20 Compliant: Callback and read errors propagated
+ * Rule 23 Compliant: Reader closed on all paths
+ *
+ * @param filename Path to the file
+ * @param chunk Scratch buffer the chunks are read into
+ * @param chunk_size Size of the scratch buffer
+ * @param callback Called once per non-empty chunk
+ * @param context Passed through to callback
+ * @param total_bytes Optional; receives the bytes delivered
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int read_config_chunks(const char *filename, char *chunk, size_t chunk_size,
+                       ConfigChunkFn callback, void *context, uint64_t *total_bytes)
+{
+    /* Rule 22: Validate input pointers */
+    if (chunk == NULL || callback == NULL)
+    {
+        REPORT_ERROR(ERROR_NULL_PARAM, "NULL parameter", NULL, 0);
+        return ERROR_NULL_PARAM;
+    }
+
+    /* Rule 22: Validate buffer size */
+    if (chunk_size == 0)
+    {
+        REPORT_ERROR(ERROR_INVALID_INPUT, "Chunk size is zero", NULL, 0);
+        return ERROR_INVALID_INPUT;
+    }
+
+    ConfigReader reader;
+    int          result = config_reader_open(&reader, filename);
+    uint64_t     total  = 0;
+
+    while (result == ERROR_NONE)
+    {
+        size_t length = 0;
+
+        result = config_reader_next(&reader, chunk, chunk_size, &length);
+        if (result != ERROR_NONE || length == 0)
+        {
+            break;
+        }
+        total  += length;
+        result  = callback(chunk, length, context);
+    }
+
+    /* Rule 23: Close on every path (no-op if open failed) */
+    config_reader_close(&reader);
+
+    if (total_bytes != NULL)
+    {
+        *total_bytes = total;
+    }
+    return result;
+}
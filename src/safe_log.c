@@ -0,0 +1,574 @@
+/**
+ * @file safe_log.c
+ * @brief Asynchronous logger: lock-free record ring plus a drainer thread.
+ *
+ * The fprintf(stderr) diagnostics of examples/compliant.c format and take
+ * the stdio lock on the caller's thread. Here a log call only reads the
+ * clock and copies a fixed-size LogRecord into a RecordRing (many
+ * producers, one consumer). A background thread drains the ring, formats
+ * records into a batch buffer and writes each batch with one write().
+ *
+ * After a push a producer only reads an atomic flag. When the ring runs
+ * dry the thread polls, then naps for growing intervals, so bursts and
+ * sporadic calls never pay for a wakeup. Only then does it set the flag
+ * and sleep (on a futex on Linux, without any lock); of the producers
+ * that see the flag, the one that clears it with a compare-and-swap
+ * issues the wakeup. An idle logger costs nothing, and logger_flush()
+ * cuts a nap short instead of waiting it out. It waits for a ticket
+ * taken on entry (the ring's head), not for an empty ring, so it returns
+ * even under sustained logging from other threads.
+ *
+ * Rules demonstrated:
+ * - Rule 20: Check all return values
+ * - Rule 21: Bounded formatting into the batch buffer
+ * - Rule 23: Free all allocated resources
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE  /* syscall() */
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <unistd.h>
+
+#ifdef __linux__
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+#endif
+
+#include "safe_runtime.h"
+#include "safe_runtime_internal.h"
+
+/* Rule 41: Constants use UPPER_CASE */
+#define LOG_DEFAULT_CAPACITY 4096u
+#define LOG_SUBJECT_SIZE     48u
+#define LOG_BATCH_RECORDS    64u
+#define LOG_BATCH_BYTES      (32u * 1024u)
+#define LOG_LINE_MAX         512u   /* Room kept free before formatting a line */
+#define LOG_IDLE_POLLS       128u   /* Empty polls before the drainer naps */
+#define LOG_IDLE_NAPS        7u     /* Naps before it sleeps until woken */
+#define LOG_NAP_FIRST_NS     50000L /* First nap; each later one doubles */
+
+/* One log call, stored unformatted */
+typedef struct LogRecord
+{
+    struct timespec  time;
+    LogLevel         level;
+    int              sys_errno;
+    int              has_value;
+    long             value;
+    const char      *function;   /* NULL for plain messages */
+    const char      *message;
+    char             subject[LOG_SUBJECT_SIZE];
+} LogRecord;
+
+struct Logger
+{
+    RecordRing     *records;
+    int             fd;
+    atomic_ulong    write_dropped;  /* Records lost to failed writes */
+    atomic_int      sleeping;       /* 1: drainer is (about to be) asleep */
+    atomic_int      stop;
+    atomic_uint     nudges;         /* Bumped to cut a nap short */
+    pthread_t       thread;
+    pthread_mutex_t lock;           /* Guards written */
+    pthread_cond_t  wake;           /* Drainer sleeps here without futexes */
+    pthread_cond_t  flushed;        /* Signalled by the drainer */
+    size_t          written;        /* Records popped and written (or dropped) */
+    LogRecord       batch[LOG_BATCH_RECORDS];
+    char            text[LOG_BATCH_BYTES];
+};
+
+static const char *level_name(LogLevel level)
+{
+    switch (level)
+    {
+        case LOG_LEVEL_DEBUG:
+            return "DEBUG";
+        case LOG_LEVEL_INFO:
+            return "INFO";
+        case LOG_LEVEL_WARNING:
+            return "WARNING";
+        case LOG_LEVEL_ERROR:
+            return "ERROR";
+        default:
+            return "?";
+    }
+}
+
+/**
+ * @brief Write all of text to fd, retrying short writes and EINTR.
+ *
+ * @return 1 if everything was written, 0 if write() failed
+ */
+static int write_all(int fd, const char *text, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, text, length);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return 0;
+        }
+        text   += written;
+        length -= (size_t)written;
+    }
+    return 1;
+}
+
+/**
+ * @brief Format one record as a line at text; never writes past room bytes.
+ *
+ * @return Bytes used, newline included
+ */
+static size_t format_record(const LogRecord *record, char *text, size_t room)
+{
+    char reason[96] = "";
+
+    if (record->sys_errno != 0 && strerror_r(record->sys_errno, reason, sizeof(reason)) != 0)
+    {
+        (void)snprintf(reason, sizeof(reason), "errno %d", record->sys_errno);
+    }
+
+    int length = snprintf(text, room, "%lld.%09ld %s %s%s%s%s%s%s", (long long)record->time.tv_sec,
+                          record->time.tv_nsec, level_name(record->level),
+                          record->function != NULL ? record->function : "",
+                          record->function != NULL ? ": " : "", record->message,
+                          record->subject[0] != '\0' ? " '" : "", record->subject,
+                          record->subject[0] != '\0' ? "'" : "");
+    if (length < 0)
+    {
+        return 0;
+    }
+    size_t used = ((size_t)length < room) ? (size_t)length : room - 1;
+
+    /* Rule 21: Every append is bounded by what is left */
+    if (record->has_value && used < room - 1)
+    {
+        length = snprintf(text + used, room - used, " %ld", record->value);
+        used   = (length > 0 && (size_t)length < room - used) ? used + (size_t)length : room - 1;
+    }
+    if (reason[0] != '\0' && used < room - 1)
+    {
+        length = snprintf(text + used, room - used, ": %s", reason);
+        used   = (length > 0 && (size_t)length < room - used) ? used + (size_t)length : room - 1;
+    }
+    text[used] = '\n';  /* Replaces the terminator; room - 1 is kept for it */
+    return used + 1;
+}
+
+/**
+ * @brief Pop up to one batch of records and write it to fd.
+ *
+ * @return Records popped (written, or counted as dropped)
+ */
+static size_t drain_batch(Logger *logger)
+{
+    size_t count = record_ring_pop(logger->records, logger->batch, LOG_BATCH_RECORDS);
+    size_t used  = 0;
+    size_t sent  = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (LOG_BATCH_BYTES - used < LOG_LINE_MAX)
+        {
+            if (!write_all(logger->fd, logger->text, used))
+            {
+                atomic_fetch_add_explicit(&logger->write_dropped, i - sent, memory_order_relaxed);
+            }
+            used = 0;
+            sent = i;
+        }
+        used += format_record(&logger->batch[i], logger->text + used, LOG_LINE_MAX);
+    }
+    if (used > 0 && !write_all(logger->fd, logger->text, used))
+    {
+        atomic_fetch_add_explicit(&logger->write_dropped, count - sent, memory_order_relaxed);
+    }
+    return count;
+}
+
+#ifdef __linux__
+/**
+ * @brief Sleep until sleeping is cleared; returns at once if it already is.
+ */
+static void drainer_sleep(Logger *logger)
+{
+    (void)syscall(SYS_futex, (int *)&logger->sleeping, FUTEX_WAIT_PRIVATE, 1, NULL, NULL, 0);
+}
+
+static void drainer_wake(Logger *logger)
+{
+    (void)syscall(SYS_futex, (int *)&logger->sleeping, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+/**
+ * @brief Wait up to nanoseconds (< 1 s) or until nudge_drainer() is called.
+ */
+static void drainer_nap(Logger *logger, long nanoseconds)
+{
+    /* Read the counter before looking at the ring: a nudge after this
+     * point makes the futex wait return at once */
+    unsigned int    seen    = atomic_load(&logger->nudges);
+    struct timespec timeout = {0, nanoseconds};
+
+    if (record_ring_pending(logger->records) == 0)
+    {
+        (void)syscall(SYS_futex, (int *)&logger->nudges, FUTEX_WAIT_PRIVATE, seen, &timeout,
+                      NULL, 0);
+    }
+}
+
+static void nudge_drainer(Logger *logger)
+{
+    (void)atomic_fetch_add(&logger->nudges, 1u);
+    (void)syscall(SYS_futex, (int *)&logger->nudges, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+#else
+static void drainer_sleep(Logger *logger)
+{
+    (void)pthread_mutex_lock(&logger->lock);
+    while (atomic_load_explicit(&logger->sleeping, memory_order_acquire) == 1)
+    {
+        (void)pthread_cond_wait(&logger->wake, &logger->lock);
+    }
+    (void)pthread_mutex_unlock(&logger->lock);
+}
+
+static void drainer_wake(Logger *logger)
+{
+    (void)pthread_mutex_lock(&logger->lock);
+    (void)pthread_cond_signal(&logger->wake);
+    (void)pthread_mutex_unlock(&logger->lock);
+}
+
+static void drainer_nap(Logger *logger, long nanoseconds)
+{
+    struct timespec deadline;
+
+    (void)clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += nanoseconds;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    /* nudge_drainer() bumps the counter under the lock, so no nudge is lost */
+    (void)pthread_mutex_lock(&logger->lock);
+    unsigned int seen   = atomic_load(&logger->nudges);
+    int          waited = 0;
+    while (waited == 0 && atomic_load(&logger->nudges) == seen &&
+           record_ring_pending(logger->records) == 0)
+    {
+        waited = pthread_cond_timedwait(&logger->wake, &logger->lock, &deadline);
+    }
+    (void)pthread_mutex_unlock(&logger->lock);
+}
+
+static void nudge_drainer(Logger *logger)
+{
+    (void)pthread_mutex_lock(&logger->lock);
+    (void)atomic_fetch_add(&logger->nudges, 1u);
+    (void)pthread_cond_signal(&logger->wake);
+    (void)pthread_mutex_unlock(&logger->lock);
+}
+#endif
+
+/**
+ * @brief Wake the drainer if it sleeps. Of any number of concurrent
+ *        callers, only the one that clears the flag makes the call.
+ */
+static void wake_drainer(Logger *logger)
+{
+    int asleep = 1;
+
+    if (atomic_load_explicit(&logger->sleeping, memory_order_relaxed) == 1 &&
+        atomic_compare_exchange_strong(&logger->sleeping, &asleep, 0))
+    {
+        drainer_wake(logger);
+    }
+}
+
+static void *drainer_main(void *arg)
+{
+    Logger *logger   = arg;
+    size_t  consumed = 0;  /* Single consumer: equals the ring's tail */
+    size_t  idle     = 0;  /* Empty polls in a row */
+
+    for (;;)
+    {
+        size_t count = drain_batch(logger);
+        consumed    += count;
+        if (count == 0 && record_ring_pending(logger->records) != 0)
+        {
+            (void)sched_yield();  /* A producer is mid-copy */
+            continue;
+        }
+
+        if (count != 0)
+        {
+            idle = 0;
+            (void)pthread_mutex_lock(&logger->lock);
+            logger->written = consumed;
+            (void)pthread_cond_broadcast(&logger->flushed);
+            (void)pthread_mutex_unlock(&logger->lock);
+            continue;
+        }
+        if (atomic_load(&logger->stop))
+        {
+            return NULL;  /* Ring empty and no more producers */
+        }
+
+        /* Back off before sleeping: poll, then nap for LOG_NAP_FIRST_NS,
+         * doubling each time. Log calls only pay for a wakeup once the
+         * logger has been idle through all of it. */
+        idle++;
+        if (idle < LOG_IDLE_POLLS)
+        {
+            (void)sched_yield();
+            continue;
+        }
+        if (idle < LOG_IDLE_POLLS + LOG_IDLE_NAPS)
+        {
+            drainer_nap(logger, LOG_NAP_FIRST_NS << (idle - LOG_IDLE_POLLS));
+            continue;
+        }
+        idle = 0;
+
+        /* Announce the sleep, then look again: a producer either sees the
+         * flag (and wakes us) or its record is seen here. The fence pairs
+         * with the one in push_record(), and with logger_destroy(). */
+        atomic_store_explicit(&logger->sleeping, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (record_ring_pending(logger->records) == 0 && !atomic_load(&logger->stop))
+        {
+            drainer_sleep(logger);
+        }
+        atomic_store_explicit(&logger->sleeping, 0, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Start a logger that writes to fd from a background thread.
+ *
+ * Rule 20 Compliant: Every initialisation step checked
+ * Rule 23 Compliant: Partial set-up undone on failure
+ *
+ * @param fd Descriptor to write log lines to
+ * @param capacity Records buffered before new ones are dropped (0: default)
+ * @return New logger, or NULL on failure
+ */
+Logger *logger_create(int fd, size_t capacity)
+{
+    /* Rule 22: Validate input */
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    Logger *logger = calloc(1, sizeof(*logger));
+    if (logger == NULL)
+    {
+        return NULL;
+    }
+    logger->fd = fd;
+    atomic_init(&logger->write_dropped, 0);
+    atomic_init(&logger->sleeping, 0);
+    atomic_init(&logger->stop, 0);
+    atomic_init(&logger->nudges, 0);
+
+    logger->records = record_ring_create(capacity != 0 ? capacity : LOG_DEFAULT_CAPACITY,
+                                         sizeof(LogRecord));
+    if (logger->records == NULL)
+    {
+        free(logger);
+        return NULL;
+    }
+
+    if (pthread_cond_init(&logger->wake, NULL) != 0)
+    {
+        record_ring_destroy(&logger->records);
+        free(logger);
+        return NULL;
+    }
+    if (pthread_cond_init(&logger->flushed, NULL) != 0)
+    {
+        (void)pthread_cond_destroy(&logger->wake);
+        record_ring_destroy(&logger->records);
+        free(logger);
+        return NULL;
+    }
+    if (pthread_mutex_init(&logger->lock, NULL) != 0)
+    {
+        (void)pthread_cond_destroy(&logger->flushed);
+        (void)pthread_cond_destroy(&logger->wake);
+        record_ring_destroy(&logger->records);
+        free(logger);
+        return NULL;
+    }
+    if (pthread_create(&logger->thread, NULL, drainer_main, logger) != 0)
+    {
+        (void)pthread_mutex_destroy(&logger->lock);
+        (void)pthread_cond_destroy(&logger->flushed);
+        (void)pthread_cond_destroy(&logger->wake);
+        record_ring_destroy(&logger->records);
+        free(logger);
+        return NULL;
+    }
+    return logger;
+}
+
+/**
+ * @brief Store one record; shared by logger_log() and the error handler.
+ */
+static int push_record(Logger *logger, LogLevel level, int sys_errno, int has_value, long value,
+                       const char *function, const char *message, const char *subject)
+{
+    LogRecord record;
+
+    /* Rule 25: Initialize every field */
+    (void)clock_gettime(CLOCK_REALTIME, &record.time);
+    record.level      = level;
+    record.sys_errno  = sys_errno;
+    record.has_value  = has_value;
+    record.value      = value;
+    record.function   = function;
+    record.message    = message;
+    size_t length     = (subject != NULL)
+                            ? safe_string_copy_kernel(record.subject, subject, LOG_SUBJECT_SIZE - 1)
+                            : 0;
+    record.subject[length] = '\0';
+
+    int result = record_ring_push(logger->records, &record);
+
+    /* Wake the drainer only if it is asleep; see drainer_main() */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (result == ERROR_NONE)
+    {
+        wake_drainer(logger);
+    }
+    return result;
+}
+
+/**
+ * @brief Log one message without blocking.
+ *
+ * Rule 22 Compliant: Validates pointers
+ *
+ * @param logger Logger to write to
+ * @param level Severity
+ * @param message Static string
+ * @param subject Optional detail, or NULL
+ * @return ERROR_NONE, ERROR_TRUNCATED if dropped, or ERROR_NULL_PARAM
+ */
+int logger_log(Logger *logger, LogLevel level, const char *message, const char *subject)
+{
+    if (logger == NULL || message == NULL)
+    {
+        return ERROR_NULL_PARAM;
+    }
+    return push_record(logger, level, 0, 0, 0, NULL, message, subject);
+}
+
+/**
+ * @brief Log a library error event through the Logger in context.
+ *
+ * @param event Event to log
+ * @param context Logger to log to
+ */
+void logger_error_handler(const ErrorEvent *event, void *context)
+{
+    Logger *logger = context;
+
+    if (event == NULL || logger == NULL)
+    {
+        return;
+    }
+    LogLevel level = (event->severity == ERROR_SEVERITY_WARNING) ? LOG_LEVEL_WARNING
+                                                                 : LOG_LEVEL_ERROR;
+    (void)push_record(logger, level, event->sys_errno, event->has_value,
+                      event->value, event->function,
+                      event->message != NULL ? event->message : "failed", event->subject);
+}
+
+/**
+ * @brief Wait until everything logged before the call has been written.
+ *
+ * Waits for the records claimed so far, not for an empty ring, so it
+ * returns even while other threads keep logging.
+ *
+ * @param logger Logger to flush (NULL is ignored)
+ */
+void logger_flush(Logger *logger)
+{
+    if (logger == NULL)
+    {
+        return;
+    }
+    size_t ticket = record_ring_claimed(logger->records);
+
+    nudge_drainer(logger);  /* Do not wait out a nap */
+    if (pthread_mutex_lock(&logger->lock) != 0)
+    {
+        return;
+    }
+    while (logger->written < ticket && !atomic_load(&logger->stop))
+    {
+        (void)pthread_cond_wait(&logger->flushed, &logger->lock);
+    }
+    (void)pthread_mutex_unlock(&logger->lock);
+}
+
+/**
+ * @brief Records dropped because the ring was full or a write failed.
+ */
+uint64_t logger_dropped(const Logger *logger)
+{
+    if (logger == NULL)
+    {
+        return 0;
+    }
+    return record_ring_dropped(logger->records) +
+           atomic_load_explicit(&logger->write_dropped, memory_order_relaxed);
+}
+
+/**
+ * @brief Write out what is buffered, stop the thread and free the logger.
+ *
+ * Rule 23 Compliant: Thread joined, ring and synchronisation freed
+ * Rule 24 Compliant: Caller's pointer set to NULL
+ *
+ * @param logger Pointer to the logger pointer (set to NULL)
+ */
+void logger_destroy(Logger **logger)
+{
+    if (logger == NULL || *logger == NULL)
+    {
+        return;
+    }
+    Logger *target = *logger;
+
+    atomic_store(&target->stop, 1);  /* seq_cst: pairs with drainer_main() */
+    wake_drainer(target);
+    nudge_drainer(target);
+    (void)pthread_join(target->thread, NULL);  /* Drains everything first */
+
+    (void)pthread_mutex_destroy(&target->lock);
+    (void)pthread_cond_destroy(&target->flushed);
+    (void)pthread_cond_destroy(&target->wake);
+    record_ring_destroy(&target->records);
+    free(target);
+    *logger = NULL;  /* Rule 24 */
+}
@@ -0,0 +1,603 @@
+/**
+ * @file safe_memory.c
+ * @brief FileData allocation and release.
+ *
+ * create_file_data() uses the heap; create_file_data_in() can take both
+ * allocations from an Arena instead. destroy_file_data() handles either.
+ * create_file_data_inline() stores the content in the same allocation as
+ * the structure.
+ *
+ * Heap FileData of up to 64 KiB is recycled through a per-thread pool. The
+ * content buffer is rounded up to a power-of-two size class, and destroyed
+ * objects (already wiped) are kept for the next create of the same class
+ * instead of going back to malloc. Pooled buffers are zero over their whole
+ * capacity, so a recycled create does no clearing. Each thread caches at
+ * most POOL_BUDGET bytes, and the cache is freed when the thread exits or
+ * file_data_pool_trim() is called. Build with SAFE_RUNTIME_NO_POOL to turn
+ * pooling off.
+ *
+ * Fresh content is never cleared by hand (Rule 25 is met by the allocator).
+ * It comes from calloc(), or for MMAP_THRESHOLD bytes and more from an
+ * anonymous mapping. Either way zero pages are faulted in only when first
+ * touched, so large, sparsely used buffers cost neither the time to clear
+ * them nor the resident memory.
+ *
+ * file_data_reserve() and file_data_append() grow content geometrically
+ * (at least doubling the capacity), so building a buffer incrementally is
+ * amortised O(1) per byte without preallocating for the worst case.
+ *
+ * Rules demonstrated:
+ * - Rule 23: Free all allocated resources
+ * - Rule 24: Prevent use-after-free
+ * - Rule 25: Initialize all variables
+ * - Rule 30: Check size arithmetic for overflow
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE  /* MAP_ANONYMOUS */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "safe_runtime.h"
+
+/* Rule 41: Constants use UPPER_CASE */
+#define POOL_MIN_SHIFT 6u   /* Smallest class: 64 bytes */
+#define POOL_CLASSES   11u  /* Up to 64 KiB */
+#define POOL_DEPTH     16u  /* Cached objects per class */
+#define POOL_BUDGET    (256u * 1024u)
+#define MMAP_THRESHOLD (1024u * 1024u)
+#define GROW_MIN       64u  /* Default capacity of an empty growable buffer */
+#define WIPE_QUERY     256u /* Pages per mincore() call when wiping a mapping */
+
+#ifndef SAFE_RUNTIME_NO_POOL
+
+typedef struct FilePool
+{
+    FileData *slots[POOL_CLASSES][POOL_DEPTH];
+    size_t    count[POOL_CLASSES];
+    size_t    bytes;
+    int       registered;  /* Thread-exit destructor installed */
+} FilePool;
+
+static _Thread_local FilePool g_pool;
+static pthread_key_t          g_pool_key;
+static pthread_once_t         g_pool_once   = PTHREAD_ONCE_INIT;
+static int                    g_pool_key_ok = 0;
+
+/**
+ * @brief Size class for a content size, or POOL_CLASSES if too large.
+ */
+static size_t pool_class(size_t size)
+{
+    size_t class_index = 0;
+
+    while (class_index < POOL_CLASSES && ((size_t)1 << (POOL_MIN_SHIFT + class_index)) < size)
+    {
+        class_index++;
+    }
+    return class_index;
+}
+
+static size_t pool_class_bytes(size_t class_index)
+{
+    return (size_t)1 << (POOL_MIN_SHIFT + class_index);
+}
+
+/**
+ * @brief Free every cached object of a pool.
+ */
+static void pool_drain(FilePool *pool)
+{
+    for (size_t c = 0; c < POOL_CLASSES; c++)
+    {
+        while (pool->count[c] > 0)
+        {
+            FileData *data = pool->slots[c][--pool->count[c]];
+
+            free(data->content);
+            free(data);
+        }
+    }
+    pool->bytes = 0;
+}
+
+static void pool_thread_exit(void *pool)
+{
+    pool_drain(pool);
+}
+
+static void pool_create_key(void)
+{
+    g_pool_key_ok = (pthread_key_create(&g_pool_key, pool_thread_exit) == 0);
+}
+
+/**
+ * @brief Cache a wiped object; returns 0 if the pool has no room.
+ */
+static int pool_push(FileData *data)
+{
+    size_t class_index = pool_class(data->capacity);
+
+    /* Only buffers created for a class are recycled into it */
+    if (class_index >= POOL_CLASSES || pool_class_bytes(class_index) != data->capacity ||
+        g_pool.count[class_index] >= POOL_DEPTH ||
+        g_pool.bytes + pool_class_bytes(class_index) > POOL_BUDGET)
+    {
+        return 0;
+    }
+
+    /* Rule 23: Register the thread-exit destructor before caching anything,
+     * so a thread's cache is never stranded */
+    if (!g_pool.registered)
+    {
+        if (pthread_once(&g_pool_once, pool_create_key) != 0 || !g_pool_key_ok ||
+            pthread_setspecific(g_pool_key, &g_pool) != 0)
+        {
+            return 0;
+        }
+        g_pool.registered = 1;
+    }
+
+    g_pool.slots[class_index][g_pool.count[class_index]++] = data;
+    g_pool.bytes += pool_class_bytes(class_index);
+    return 1;
+}
+
+static FileData *pool_pop(size_t class_index)
+{
+    if (g_pool.count[class_index] == 0)
+    {
+        return NULL;
+    }
+    g_pool.bytes -= pool_class_bytes(class_index);
+    return g_pool.slots[class_index][--g_pool.count[class_index]];
+}
+
+#endif /* SAFE_RUNTIME_NO_POOL */
+
+/**
+ * @brief Free the calling thread's cached FileData objects.
+ */
+void file_data_pool_trim(void)
+{
+#ifndef SAFE_RUNTIME_NO_POOL
+    pool_drain(&g_pool);
+#endif
+}
+
+/**
+ * @brief Get zeroed content memory of at least size bytes.
+ *
+ * @param capacity In: bytes wanted; out: bytes actually allocated
+ * @return Zeroed memory, or NULL on failure
+ */
+static char *allocate_zeroed(size_t *capacity)
+{
+    if (*capacity < MMAP_THRESHOLD)
+    {
+        return calloc(1, *capacity);
+    }
+
+    /* Rule 30: Round up to whole pages without overflowing */
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0 || *capacity > SIZE_MAX - (size_t)page)
+    {
+        return NULL;
+    }
+    size_t mapped = (*capacity + (size_t)page - 1) & ~((size_t)page - 1);
+    void  *memory = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        return NULL;
+    }
+    *capacity = mapped;
+    return memory;
+}
+
+/**
+ * @brief Wipe content from allocate_zeroed() before it is released.
+ *
+ * Mapped content is wiped one resident page at a time. A page that was
+ * never touched is not resident and holds no data, and wiping it would
+ * only fault it in, so a sparse buffer is released without costing the
+ * time or memory of its whole capacity. If mincore() fails, the whole
+ * range is wiped.
+ */
+static void wipe_zeroed(char *content, size_t capacity)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    if (capacity < MMAP_THRESHOLD || page <= 0)
+    {
+        secure_wipe(content, capacity);
+        return;
+    }
+
+    size_t        query = WIPE_QUERY * (size_t)page;
+    unsigned char resident[WIPE_QUERY];
+    for (size_t offset = 0; offset < capacity; offset += query)
+    {
+        size_t length = (capacity - offset < query) ? capacity - offset : query;
+
+        /* Rule 20: Fall back to a full wipe; void * fits every mincore() */
+        if (mincore(content + offset, length, (void *)resident) != 0)
+        {
+            secure_wipe(content + offset, length);
+            continue;
+        }
+        for (size_t done = 0, i = 0; done < length; done += (size_t)page, i++)
+        {
+            if (resident[i] & 1u)
+            {
+                secure_wipe(content + offset + done, (size_t)page);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Return memory from allocate_zeroed().
+ */
+static void release_zeroed(char *content, size_t capacity)
+{
+    if (capacity < MMAP_THRESHOLD)
+    {
+        free(content);
+    }
+    else
+    {
+        (void)munmap(content, capacity);
+    }
+}
+
+/**
+ * @brief Allocate and initialize a FileData structure.
+ *
+ * Demonstrates proper allocation and initialization patterns.
+ *
+ * @param size Size of content buffer to allocate
+ * @return Pointer to allocated structure, or NULL on failure
+ */
+FileData *create_file_data(size_t size)
+{
+    /* Rule 22: Validate input */
+    if (size == 0)
+    {
+        return NULL;
+    }
+
+    size_t capacity = size;
+#ifndef SAFE_RUNTIME_NO_POOL
+    size_t class_index = pool_class(size);
+    if (class_index < POOL_CLASSES)
+    {
+        capacity = pool_class_bytes(class_index);
+
+        /* Recycled content is already zero over its whole capacity */
+        FileData *recycled = pool_pop(class_index);
+        if (recycled != NULL)
+        {
+            recycled->size  = size;
+            recycled->valid = 1;
+            return recycled;
+        }
+    }
+#endif
+
+    /* Rule 20: Check malloc return value */
+    FileData *data = malloc(sizeof(FileData));
+    if (data == NULL)
+    {
+        return NULL;
+    }
+
+    /* Rule 25: Initialize all fields */
+    data->content  = NULL;
+    data->size     = 0;
+    data->capacity = 0;
+    data->valid    = 0;
+    data->arena    = NULL;
+
+    /* Rule 20: Check allocation result; Rule 25: memory arrives zeroed */
+    data->content = allocate_zeroed(&capacity);
+    if (data->content == NULL)
+    {
+        free(data);  /* Rule 23: Clean up partial allocation */
+        return NULL;
+    }
+
+    data->size     = size;
+    data->capacity = capacity;
+    data->valid    = 1;
+
+    return data;
+}
+
+/**
+ * @brief Free a FileData structure and all its resources.
+ *
+ * Rule 23 Compliant: Frees all allocated memory
+ * Rule 24 Compliant: Clears pointer after free
+ *
+ * @param data Pointer to pointer to FileData (set to NULL after free)
+ */
+void destroy_file_data(FileData **data)
+{
+    /* Rule 22: Validate pointers */
+    if (data == NULL || *data == NULL)
+    {
+        return;
+    }
+
+    /* Arena memory goes back when the arena is rewound, reset or destroyed,
+     * which wipes all of it; the content itself is wiped now */
+    if ((*data)->arena != NULL)
+    {
+        secure_wipe((*data)->content, (*data)->size);
+        memset(*data, 0, sizeof(**data));
+        *data = NULL;  /* Rule 24 */
+        return;
+    }
+
+    /* Clear sensitive data before freeing, unmapping or recycling. The
+     * kernel zero-fills unmapped pages only when it hands them out again,
+     * so mapped content is wiped as well, resident pages only. The whole
+     * capacity is covered: callers may lower size below bytes they wrote,
+     * and a recycled buffer must be zero over all of it. */
+    if ((*data)->content != NULL)
+    {
+        wipe_zeroed((*data)->content, (*data)->capacity);
+    }
+
+#ifndef SAFE_RUNTIME_NO_POOL
+    if ((*data)->content != NULL && pool_push(*data))
+    {
+        (*data)->valid = 0;
+        *data          = NULL;  /* Rule 24 */
+        return;
+    }
+#endif
+
+    /* Rule 23: Free nested allocation first */
+    if ((*data)->content != NULL)
+    {
+        release_zeroed((*data)->content, (*data)->capacity);
+        (*data)->content = NULL;  /* Rule 24 */
+    }
+
+    /* Rule 23: Free the structure */
+    free(*data);
+
+    /* Rule 24: Set caller's pointer to NULL */
+    *data = NULL;
+}
+
+/**
+ * @brief Allocate a FileData structure, optionally from an arena.
+ *
+ * Rule 20 Compliant: Returns NULL on allocation failure
+ * Rule 25 Compliant: Arena memory is already zeroed
+ *
+ * @param arena Arena to allocate from, or NULL for the heap
+ * @param size Size of content buffer to allocate
+ * @return Pointer to allocated structure, or NULL on failure
+ */
+FileData *create_file_data_in(Arena *arena, size_t size)
+{
+    if (arena == NULL)
+    {
+        return create_file_data(size);
+    }
+
+    /* Rule 22: Validate input */
+    if (size == 0)
+    {
+        return NULL;
+    }
+
+    ArenaMark mark    = arena_mark(arena);
+    FileData *data    = arena_alloc(arena, sizeof(FileData));
+    char     *content = (data != NULL) ? arena_alloc(arena, size) : NULL;
+    if (content == NULL)
+    {
+        arena_rewind(arena, mark);  /* Rule 23: Give back the partial allocation */
+        return NULL;
+    }
+
+    data->content  = content;
+    data->size     = size;
+    data->capacity = size;
+    data->valid    = 1;
+    data->arena    = arena;
+    return data;
+}
+
+/**
+ * @brief Allocate an empty FileData to be filled with file_data_append().
+ *
+ * Rule 20 Compliant: Returns NULL on allocation failure
+ *
+ * @param capacity Bytes to reserve up front, or 0 for a small default
+ * @return Pointer to a FileData with size 0, or NULL on failure
+ */
+FileData *create_file_data_empty(size_t capacity)
+{
+    FileData *data = create_file_data((capacity != 0) ? capacity : GROW_MIN);
+    if (data != NULL)
+    {
+        data->size = 0;
+    }
+    return data;
+}
+
+/**
+ * @brief Make room for at least capacity bytes of content.
+ *
+ * Content up to size is kept and everything beyond it stays zero.
+ *
+ * Rule 22 Compliant: Validates arguments
+ * Rule 23 Compliant: Old buffer wiped and released after the move
+ * Rule 30 Compliant: Growth arithmetic checked for overflow
+ *
+ * @param data FileData to grow (heap or arena)
+ * @param capacity Minimum capacity wanted
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int file_data_reserve(FileData *data, size_t capacity)
+{
+    /* Rule 22: Validate input */
+    if (data == NULL || data->content == NULL || !data->valid)
+    {
+        return ERROR_NULL_PARAM;
+    }
+    if (capacity <= data->capacity)
+    {
+        return ERROR_NONE;
+    }
+
+    /* Rule 30: Doubling must not overflow; fall back to the exact need */
+    size_t grown = (data->capacity <= SIZE_MAX / 2) ? data->capacity * 2 : SIZE_MAX;
+    if (grown < capacity)
+    {
+        grown = capacity;
+    }
+#ifndef SAFE_RUNTIME_NO_POOL
+    /* Land on a size class so the buffer can be recycled */
+    size_t class_index = pool_class(grown);
+    if (data->arena == NULL && class_index < POOL_CLASSES)
+    {
+        grown = pool_class_bytes(class_index);
+    }
+#endif
+
+    char *content = (data->arena != NULL) ? arena_alloc(data->arena, grown)
+                                          : allocate_zeroed(&grown);
+    if (content == NULL)
+    {
+        return ERROR_MEMORY;
+    }
+    memcpy(content, data->content, data->size);
+
+    /* Rule 23: Wipe the old copy; arena memory goes back with the arena */
+    if (data->arena != NULL)
+    {
+        secure_wipe(data->content, data->capacity);
+    }
+    else
+    {
+        wipe_zeroed(data->content, data->capacity);
+        release_zeroed(data->content, data->capacity);
+    }
+
+    data->content  = content;
+    data->capacity = grown;
+    return ERROR_NONE;
+}
+
+/**
+ * @brief Append bytes to a FileData, growing it as needed.
+ *
+ * One byte of spare capacity is always kept, so content stays
+ * NUL-terminated at content[size].
+ *
+ * Rule 22 Compliant: Validates arguments
+ * Rule 30 Compliant: Size arithmetic checked for overflow
+ *
+ * @param data FileData to append to
+ * @param bytes Bytes to append (may be NULL when length is 0)
+ * @param length Number of bytes
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int file_data_append(FileData *data, const void *bytes, size_t length)
+{
+    /* Rule 22: Validate input */
+    if (data == NULL || (bytes == NULL && length != 0))
+    {
+        return ERROR_NULL_PARAM;
+    }
+
+    /* Rule 30: New size plus the terminator must not overflow */
+    if (length > SIZE_MAX - 1 - data->size)
+    {
+        return ERROR_OVERFLOW;
+    }
+
+    int result = file_data_reserve(data, data->size + length + 1);
+    if (result != ERROR_NONE)
+    {
+        return result;
+    }
+    if (length != 0)
+    {
+        memcpy(data->content + data->size, bytes, length);
+        data->size += length;
+    }
+    return ERROR_NONE;
+}
+
+/**
+ * @brief Allocate a FileDataInline in a single block.
+ *
+ * Rule 20 Compliant: Checks calloc return value
+ * Rule 25 Compliant: Content zeroed by calloc
+ * Rule 30 Compliant: Total size checked for overflow
+ *
+ * @param size Size of content buffer to allocate
+ * @return Pointer to allocated structure, or NULL on failure
+ */
+FileDataInline *create_file_data_inline(size_t size)
+{
+    /* Rule 22: Validate input */
+    if (size == 0)
+    {
+        return NULL;
+    }
+
+    /* Rule 30: Header plus content must not overflow */
+    if (size > SIZE_MAX - sizeof(FileDataInline))
+    {
+        return NULL;
+    }
+
+    /* Rule 20: Check calloc return value; Rule 25: content arrives zeroed */
+    FileDataInline *data = calloc(1, sizeof(FileDataInline) + size);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+
+    data->size  = size;
+    data->valid = 1;
+
+    return data;
+}
+
+/**
+ * @brief Free a FileDataInline.
+ *
+ * Rule 23 Compliant: One allocation, one free
+ * Rule 24 Compliant: Clears pointer after free
+ *
+ * @param data Pointer to pointer to FileDataInline (set to NULL after free)
+ */
+void destroy_file_data_inline(FileDataInline **data)
+{
+    /* Rule 22: Validate pointers */
+    if (data == NULL || *data == NULL)
+    {
+        return;
+    }
+
+    /* Clear sensitive data before freeing */
+    secure_wipe((*data)->content, (*data)->size);
+    (*data)->valid = 0;
+    free(*data);
+
+    /* Rule 24: Set caller's pointer to NULL */
+    *data = NULL;
+}
@@ -0,0 +1,284 @@
+/**
+ * @file safe_process.c
+ * @brief Data processing with goto-cleanup resource management.
+ *
+ * process_data() copies its input into a BUFFER_SIZE stack buffer, so it
+ * makes no allocator call; longer input is cut to fit, as it always was.
+ * process_data_in() takes its scratch buffer from an Arena and rewinds it
+ * on exit, so repeated calls reuse the same arena memory.
+ *
+ * process_data_batch() formats many inputs into one output buffer and
+ * writes it with a single write() when it fills or at the end, instead of
+ * one locked, possibly flushed printf() per input. A write failure is
+ * charged to every input with bytes in that buffer.
+ *
+ * Rules demonstrated:
+ * - Rule 23: Free all allocated resources
+ * - Rule 24: Prevent use-after-free
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+#include "safe_runtime.h"
+#include "safe_runtime_internal.h"
+
+/* Rule 41: Constants use UPPER_CASE */
+#define BUFFER_SIZE       256
+#define BATCH_BUFFER_SIZE 8192
+#define NO_ITEM           SIZE_MAX
+
+static const char PROCESSED_PREFIX[] = "Processed: ";
+
+/* Output buffer shared by one process_data_batch() call */
+typedef struct BatchOutput
+{
+    int     fd;
+    char   *buffer;
+    size_t  size;
+    size_t  used;
+    size_t  item;           /* Input being formatted */
+    size_t  first;          /* First input with bytes in buffer, or NO_ITEM */
+    int    *status;         /* Caller's per-input status, or NULL */
+    size_t  failed;         /* Lowest failed input so far, or NO_ITEM */
+    int     failed_status;
+} BatchOutput;
+
+/**
+ * @brief Process data with proper resource management.
+ *
+ * Rule 21 Compliant: Input cut to BUFFER_SIZE - 1 bytes
+ * Rule 23 Compliant: Uses goto cleanup pattern
+ *
+ * The scratch buffer is on the stack: there is nothing to allocate or free.
+ *
+ * @param input Input string to process
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int process_data(const char *input)
+{
+    /* Rule 25: Initialize all variables */
+    int    result = ERROR_MEMORY;
+    char   buffer[BUFFER_SIZE];  /* Filled by the copy below */
+
+    /* Rule 22: Validate input */
+    if (input == NULL)
+    {
+        return ERROR_NULL_PARAM;
+    }
+
+    /* Safe copy with bounds checking */
+    if (safe_string_copy(buffer, BUFFER_SIZE, input) < 0)
+    {
+        REPORT_ERROR(ERROR_MEMORY, "String copy failed", NULL, 0);
+        goto cleanup;
+    }
+
+    /* Process the data */
+    printf("Processed: %s\n", buffer);
+    result = ERROR_NONE;
+
+cleanup:
+    /* Rule 23: Nothing to release; the buffer goes with the stack frame */
+    return result;
+}
+
+/**
+ * @brief Process data using scratch memory from an arena.
+ *
+ * Rule 23 Compliant: Arena rewound on every path
+ *
+ * @param arena Arena for the scratch buffer, or NULL for the heap
+ * @param input Input string to process
+ * @return ERROR_NONE on success, negative error code on failure
+ */
+int process_data_in(Arena *arena, const char *input)
+{
+    if (arena == NULL)
+    {
+        return process_data(input);
+    }
+
+    /* Rule 22: Validate input */
+    if (input == NULL)
+    {
+        return ERROR_NULL_PARAM;
+    }
+
+    int       result = ERROR_MEMORY;
+    ArenaMark mark   = arena_mark(arena);
+
+    /* Rule 20: Check allocation result */
+    char *buffer = arena_alloc(arena, BUFFER_SIZE);
+    if (buffer == NULL)
+    {
+        REPORT_ERROR(ERROR_MEMORY, "Memory allocation failed", NULL, 0);
+        goto cleanup;
+    }
+
+    if (safe_string_copy(buffer, BUFFER_SIZE, input) < 0)
+    {
+        REPORT_ERROR(ERROR_MEMORY, "String copy failed", NULL, 0);
+        goto cleanup;
+    }
+
+    printf("Processed: %s\n", buffer);
+    result = ERROR_NONE;
+
+cleanup:
+    /* Rule 23 & 24: Release (and wipe) the scratch buffer */
+    arena_rewind(arena, mark);
+    buffer = NULL;
+
+    return result;
+}
+
+/**
+ * @brief Record status for inputs [from, to] that have not already failed.
+ */
+static void batch_fail(BatchOutput *out, size_t from, size_t to, int status)
+{
+    for (size_t i = from; out->status != NULL && i <= to; i++)
+    {
+        if (out->status[i] == ERROR_NONE)
+        {
+            out->status[i] = status;
+        }
+    }
+    if (out->failed == NO_ITEM || from < out->failed)
+    {
+        out->failed        = from;
+        out->failed_status = status;
+    }
+}
+
+/**
+ * @brief Write the buffered bytes with one write(), retrying short writes.
+ *
+ * Rule 20 Compliant: Failure charged to every input in the buffer
+ */
+static void batch_flush(BatchOutput *out)
+{
+    const char *bytes  = out->buffer;
+    size_t      length = out->used;
+
+    while (length > 0)
+    {
+        ssize_t written = write(out->fd, bytes, length);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            REPORT_ERROR(ERROR_FILE_WRITE, "Write failed", NULL, errno);
+            batch_fail(out, out->first, out->item, ERROR_FILE_WRITE);
+            break;
+        }
+        bytes  += written;
+        length -= (size_t)written;
+    }
+    out->used  = 0;
+    out->first = NO_ITEM;
+}
+
+/**
+ * @brief Copy bytes into the buffer, flushing each time it fills.
+ *
+ * Rule 21 Compliant: Every copy bounded by the space left
+ */
+static void batch_put(BatchOutput *out, const char *bytes, size_t length)
+{
+    while (length > 0)
+    {
+        size_t room = out->size - out->used;
+        size_t part = (length < room) ? length : room;
+
+        memcpy(out->buffer + out->used, bytes, part);
+        out->used += part;
+        bytes     += part;
+        length    -= part;
+        if (out->first == NO_ITEM)
+        {
+            out->first = out->item;
+        }
+        if (out->used == out->size)
+        {
+            batch_flush(out);
+        }
+    }
+}
+
+/**
+ * @brief Process many inputs, writing all their output with few write() calls.
+ *
+ * Rule 20 Compliant: Per-input status instead of stopping at the first error
+ * Rule 22 Compliant: Validates every pointer
+ *
+ * @param fd Descriptor to write to
+ * @param inputs Input strings; NULL entries fail with ERROR_NULL_PARAM
+ * @param count Number of inputs
+ * @param buffer Output buffer reused across calls, or NULL for an internal one
+ * @param buffer_size Size of buffer (ignored when buffer is NULL)
+ * @param out_status Optional; receives one status per input
+ * @return ERROR_NONE if every input was written, otherwise the status of the
+ *         first input that failed
+ */
+int process_data_batch(int fd, const char *const *inputs, size_t count, char *buffer,
+                       size_t buffer_size, int *out_status)
+{
+    char local[BATCH_BUFFER_SIZE];
+
+    /* Rule 22: Validate input */
+    if (count != 0 && inputs == NULL)
+    {
+        return ERROR_NULL_PARAM;
+    }
+    if (fd < 0 || (buffer != NULL && buffer_size == 0))
+    {
+        return ERROR_INVALID_INPUT;
+    }
+
+    /* Rule 25: Initialize every field */
+    BatchOutput out;
+    out.fd            = fd;
+    out.buffer        = (buffer != NULL) ? buffer : local;
+    out.size          = (buffer != NULL) ? buffer_size : sizeof(local);
+    out.used          = 0;
+    out.item          = 0;
+    out.first         = NO_ITEM;
+    out.status        = out_status;
+    out.failed        = NO_ITEM;
+    out.failed_status = ERROR_NONE;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        out.item = i;
+        if (out_status != NULL)
+        {
+            out_status[i] = ERROR_NONE;
+        }
+        if (inputs[i] == NULL)
+        {
+            batch_fail(&out, i, i, ERROR_NULL_PARAM);
+            continue;
+        }
+        batch_put(&out, PROCESSED_PREFIX, sizeof(PROCESSED_PREFIX) - 1);
+        /* Rule 21: Cut like process_data(), with a bounded scan */
+        batch_put(&out, inputs[i], strnlen(inputs[i], BUFFER_SIZE - 1));
+        batch_put(&out, "\n", 1);
+    }
+    if (out.used > 0)
+    {
+        batch_flush(&out);
+    }
+
+    return (out.failed == NO_ITEM) ? ERROR_NONE : out.failed_status;
+}
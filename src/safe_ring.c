@@ -0,0 +1,227 @@
+/**
+ * @file safe_ring.c
+ * @brief Lock-free bounded ring of fixed-size records.
+ *
+ * Slot i of a ring with capacity C (a power of two) carries a sequence
+ * number. It is t when the slot is free for the producer holding ticket t,
+ * and t + 1 once that producer's record is in it. A producer takes the next
+ * ticket with a compare-and-swap on head, copies its record in and
+ * publishes it by storing t + 1 (release). A consumer does the same on tail,
+ * copies the record out and frees the slot for ticket t + C. Nobody waits
+ * on a lock, and a full ring drops the new record instead of blocking.
+ *
+ * Slots are cache-line multiples, so producers writing neighbouring slots
+ * do not false-share, and head, tail and the drop counter each have a line.
+ *
+ * Rules demonstrated:
+ * - Rule 20: Check all return values
+ * - Rule 23: Free all allocated resources
+ * - Rule 30: Check size arithmetic for overflow
+ */
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "safe_runtime_internal.h"
+
+/* Rule 41: Constants use UPPER_CASE */
+#define RING_CACHE_LINE   64u
+#define RING_MIN_CAPACITY 2u
+
+typedef struct RecordSlot
+{
+    atomic_size_t sequence;
+    alignas(max_align_t) unsigned char record[];
+} RecordSlot;
+
+struct RecordRing
+{
+    alignas(RING_CACHE_LINE) atomic_size_t head;  /* Next producer ticket */
+    alignas(RING_CACHE_LINE) atomic_size_t tail;  /* Next consumer ticket */
+    alignas(RING_CACHE_LINE) atomic_uint_least64_t dropped;
+    alignas(RING_CACHE_LINE) unsigned char *slots;
+    size_t mask;
+    size_t stride;
+    size_t record_size;
+};
+
+static RecordSlot *slot_at(const RecordRing *ring, size_t ticket)
+{
+    return (RecordSlot *)(void *)(ring->slots + (ticket & ring->mask) * ring->stride);
+}
+
+/**
+ * @brief Round size up to a multiple of RING_CACHE_LINE.
+ *
+ * @return Rounded size, or 0 on overflow
+ */
+static size_t round_to_line(size_t size)
+{
+    if (size > SIZE_MAX - (RING_CACHE_LINE - 1))
+    {
+        return 0;
+    }
+    return (size + RING_CACHE_LINE - 1) & ~(size_t)(RING_CACHE_LINE - 1);
+}
+
+RecordRing *record_ring_create(size_t capacity, size_t record_size)
+{
+    /* Rule 22: Validate input */
+    if (record_size == 0 || capacity > (SIZE_MAX >> 1) + 1)
+    {
+        return NULL;
+    }
+
+    size_t slots = RING_MIN_CAPACITY;
+    while (slots < capacity)
+    {
+        slots <<= 1;
+    }
+
+    /* Rule 30: Slot stride and total size must not overflow */
+    size_t header = offsetof(RecordSlot, record);
+    size_t stride = (record_size <= SIZE_MAX - header) ? round_to_line(header + record_size) : 0;
+    if (stride == 0 || slots > SIZE_MAX / stride)
+    {
+        return NULL;
+    }
+
+    RecordRing *ring = aligned_alloc(RING_CACHE_LINE, round_to_line(sizeof(RecordRing)));
+    if (ring == NULL)
+    {
+        return NULL;
+    }
+    ring->slots = aligned_alloc(RING_CACHE_LINE, slots * stride);
+    if (ring->slots == NULL)
+    {
+        free(ring);  /* Rule 23: Clean up partial allocation */
+        return NULL;
+    }
+
+    /* Rule 25: Initialize everything; slot t starts free for ticket t */
+    memset(ring->slots, 0, slots * stride);
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->dropped, 0);
+    ring->mask        = slots - 1;
+    ring->stride      = stride;
+    ring->record_size = record_size;
+    for (size_t i = 0; i < slots; i++)
+    {
+        atomic_init(&slot_at(ring, i)->sequence, i);
+    }
+    return ring;
+}
+
+int record_ring_push(RecordRing *ring, const void *record)
+{
+    size_t      ticket = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    RecordSlot *slot   = NULL;
+
+    for (;;)
+    {
+        slot = slot_at(ring, ticket);
+
+        size_t   sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t lag      = (intptr_t)(sequence - ticket);
+        if (lag == 0)
+        {
+            /* Free for this ticket: claim it (reloads ticket on failure) */
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &ticket, ticket + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (lag < 0)
+        {
+            /* Still holds the record from one lap ago: full */
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            return ERROR_TRUNCATED;
+        }
+        else
+        {
+            ticket = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+
+    memcpy(slot->record, record, ring->record_size);
+    atomic_store_explicit(&slot->sequence, ticket + 1, memory_order_release);
+    return ERROR_NONE;
+}
+
+size_t record_ring_pop(RecordRing *ring, void *records, size_t max)
+{
+    unsigned char *out   = records;
+    size_t         count = 0;
+
+    while (count < max)
+    {
+        size_t      ticket = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        RecordSlot *slot   = NULL;
+
+        for (;;)
+        {
+            slot = slot_at(ring, ticket);
+
+            size_t   sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+            intptr_t lag      = (intptr_t)(sequence - (ticket + 1));
+            if (lag == 0)
+            {
+                if (atomic_compare_exchange_weak_explicit(&ring->tail, &ticket, ticket + 1,
+                                                          memory_order_relaxed,
+                                                          memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (lag < 0)
+            {
+                return count;  /* Empty, or the next record is not published yet */
+            }
+            else
+            {
+                ticket = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            }
+        }
+
+        memcpy(out + count * ring->record_size, slot->record, ring->record_size);
+        atomic_store_explicit(&slot->sequence, ticket + ring->mask + 1, memory_order_release);
+        count++;
+    }
+    return count;
+}
+
+size_t record_ring_pending(const RecordRing *ring)
+{
+    /* Read tail first: head only grows, so the difference cannot go negative */
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    return head - tail;
+}
+
+size_t record_ring_claimed(const RecordRing *ring)
+{
+    return atomic_load_explicit(&ring->head, memory_order_acquire);
+}
+
+uint64_t record_ring_dropped(const RecordRing *ring)
+{
+    return atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+}
+
+void record_ring_destroy(RecordRing **ring)
+{
+    if (ring == NULL || *ring == NULL)
+    {
+        return;
+    }
+    free((*ring)->slots);
+    free(*ring);
+    *ring = NULL;  /* Rule 24 */
+}
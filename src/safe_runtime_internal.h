@@ -0,0 +1,122 @@
+/**
+ * @file safe_runtime_internal.h
+ * @brief Internal kernels shared between safe_runtime translation units.
+ *
+ * Not installed; nothing here is part of the public API.
+ */
+
+#ifndef SAFE_RUNTIME_INTERNAL_H
+#define SAFE_RUNTIME_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "safe_runtime.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define SAFE_RUNTIME_INTERNAL __attribute__((visibility("hidden")))
+#else
+    #define SAFE_RUNTIME_INTERNAL
+#endif
+
+/**
+ * @brief Copy src into dest until a NUL byte or limit bytes, in one pass.
+ *
+ * Does not write a terminator. Reads of src never cross into an aligned
+ * block beyond the terminator or beyond src + limit, so it cannot fault on
+ * a string that ends at the edge of a mapping.
+ *
+ * @param dest Destination (at least limit bytes)
+ * @param src Source string
+ * @param limit Maximum number of bytes to copy
+ * @return Number of bytes copied (the NUL is not counted or copied)
+ */
+SAFE_RUNTIME_INTERNAL size_t safe_string_copy_kernel(char *dest, const char *src, size_t limit);
+
+/* --------------------------------------------------------------------------
+ * Error reporting (safe_error.c)
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @brief Hand one event to the installed ErrorReporter (stderr by default).
+ *
+ * errno is preserved across the call.
+ */
+SAFE_RUNTIME_INTERNAL void report_event(const ErrorEvent *event);
+
+/**
+ * @brief Report a failure without a value.
+ *
+ * @param message Static string; ring handlers keep the pointer
+ * @param subject What the operation failed on (e.g. a path), or NULL
+ * @param sys_errno errno describing the failure, or 0
+ */
+SAFE_RUNTIME_INTERNAL void report_error(ErrorSeverity severity, int code, const char *function,
+                                        const char *message, const char *subject,
+                                        int sys_errno);
+
+/* Call-site shorthands that capture the reporting function's name */
+#define REPORT_ERROR(code, message, subject, sys_errno) \
+    report_error(ERROR_SEVERITY_ERROR, (code), __func__, (message), (subject), (sys_errno))
+#define REPORT_WARNING(message, subject, sys_errno) \
+    report_error(ERROR_SEVERITY_WARNING, ERROR_NONE, __func__, (message), (subject), (sys_errno))
+
+/* --------------------------------------------------------------------------
+ * Lock-free ring of fixed-size records (safe_ring.c)
+ *
+ * Bounded multi-producer/multi-consumer queue: each slot carries a sequence
+ * number that says whose turn it is, so producers and consumers claim
+ * slots with one compare-and-swap and never take a lock. A full ring drops
+ * the new record and counts it instead of blocking.
+ * -------------------------------------------------------------------------- */
+
+typedef struct RecordRing RecordRing;
+
+/**
+ * @brief Create a ring of at least capacity records of record_size bytes.
+ *
+ * @return New ring, or NULL on failure or overflow
+ */
+SAFE_RUNTIME_INTERNAL RecordRing *record_ring_create(size_t capacity, size_t record_size);
+
+/**
+ * @brief Copy one record in; never blocks.
+ *
+ * @return ERROR_NONE, or ERROR_TRUNCATED if the ring was full (counted)
+ */
+SAFE_RUNTIME_INTERNAL int record_ring_push(RecordRing *ring, const void *record);
+
+/**
+ * @brief Copy up to max of the oldest records out, in order.
+ *
+ * @return Number of records copied
+ */
+SAFE_RUNTIME_INTERNAL size_t record_ring_pop(RecordRing *ring, void *records, size_t max);
+
+/**
+ * @brief Records claimed by producers but not yet popped.
+ *
+ * Includes records still being copied in, which record_ring_pop() cannot
+ * return yet; a consumer that must see everything waits for 0.
+ */
+SAFE_RUNTIME_INTERNAL size_t record_ring_pending(const RecordRing *ring);
+
+/**
+ * @brief Tickets claimed by producers since creation.
+ *
+ * Records are popped in ticket order, so once a single consumer has popped
+ * this many records, everything pushed before the call has been popped.
+ */
+SAFE_RUNTIME_INTERNAL size_t record_ring_claimed(const RecordRing *ring);
+
+/**
+ * @brief Records dropped because the ring was full.
+ */
+SAFE_RUNTIME_INTERNAL uint64_t record_ring_dropped(const RecordRing *ring);
+
+/**
+ * @brief Free a ring and clear the caller's pointer.
+ */
+SAFE_RUNTIME_INTERNAL void record_ring_destroy(RecordRing **ring);
+
+#endif /* SAFE_RUNTIME_INTERNAL_H */
@@ -0,0 +1,378 @@
+/**
+ * @file safe_string.c
+ * @brief Bounded string copy.
+ *
+ * The copy finds the terminator and copies in a single pass that stops at
+ * dest_size - 1 bytes, instead of strlen() over the whole source followed
+ * by memcpy(). On x86-64 the pass is vectorised (AVX2 when the CPU has it,
+ * SSE2 otherwise, chosen at run time); elsewhere, or when built with
+ * SAFE_RUNTIME_NO_SIMD, it uses a bounded memchr() and memcpy().
+ *
+ * safe_string_copy_bounded() shares the kernel and also reports whether the
+ * source was truncated, reading at most dest_size bytes of it.
+ * safe_string_copy_batch() validates a whole array of fields up front, picks
+ * the kernel once, and records truncation in a bitmask without branching.
+ *
+ * Rules demonstrated:
+ * - Rule 20: Report truncation as a status code
+ * - Rule 21: Prevent buffer overflows
+ * - Rule 22: Prevent null pointer dereference
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "safe_runtime.h"
+#include "safe_runtime_internal.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(SAFE_RUNTIME_NO_SIMD)
+    #define SAFE_STRING_X86_SIMD 1
+    #include <immintrin.h>
+#else
+    #define SAFE_STRING_X86_SIMD 0
+#endif
+
+/* Copies until NUL or limit bytes; see safe_string_copy_kernel() */
+typedef size_t (*CopyKernel)(char *dest, const char *src, size_t limit);
+
+/* Copies count pre-validated fields; see safe_string_copy_batch() */
+typedef void (*CopyBatch)(const StringCopyField *fields, size_t count, uint64_t *truncated);
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define SAFE_STRING_INLINE inline __attribute__((always_inline))
+#else
+    #define SAFE_STRING_INLINE inline
+#endif
+
+/**
+ * @brief Batch loop shared by every kernel.
+ *
+ * Always inlined into a per-kernel wrapper, so the kernel is a constant and
+ * is inlined too instead of being called through a pointer per field.
+ */
+static SAFE_STRING_INLINE void copy_fields(const StringCopyField *fields, size_t count,
+                                           uint64_t *truncated, CopyKernel kernel)
+{
+    for (size_t word = 0; word < (count + 63u) / 64u; word++)
+    {
+        truncated[word] = 0;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        const StringCopyField *field  = &fields[i];
+        size_t                 copied = kernel(field->dest, field->src, field->dest_size - 1);
+
+        field->dest[copied] = '\0';
+
+        /* src[copied] is the terminator unless the copy hit the limit, in
+         * which case it is the first byte that did not fit */
+        truncated[i / 64u] |= (uint64_t)(field->src[copied] != '\0') << (i % 64u);
+    }
+}
+
+#if SAFE_STRING_X86_SIMD
+
+/*
+ * Both kernels only issue aligned vector loads. An aligned load never spans
+ * two pages, so reading the whole block that contains the terminator (or
+ * the last permitted byte) cannot fault even though it may read a few bytes
+ * past them. Those bytes are never copied; AddressSanitizer is told to
+ * ignore the over-read.
+ */
+#if defined(__has_feature)
+    #if __has_feature(address_sanitizer)
+        #define SAFE_STRING_NO_ASAN __attribute__((no_sanitize_address))
+    #endif
+#elif defined(__SANITIZE_ADDRESS__)
+    #define SAFE_STRING_NO_ASAN __attribute__((no_sanitize_address))
+#endif
+#ifndef SAFE_STRING_NO_ASAN
+    #define SAFE_STRING_NO_ASAN
+#endif
+
+/* Rule 41: Constants use UPPER_CASE */
+#define SSE2_BLOCK 16u
+#define AVX2_BLOCK 32u
+
+static const char *align_down(const char *ptr, uintptr_t block)
+{
+    return (const char *)((uintptr_t)ptr & ~(block - 1u));
+}
+
+/**
+ * @brief Copy the final (possibly partial) run of bytes found in a block.
+ *
+ * @param mask NUL bitmask for the block, bit 0 = first byte at dest/src
+ * @param available Bytes of the block at or after src
+ * @param remaining Bytes still allowed by the limit
+ */
+static size_t copy_tail(char *dest, const char *src, uint32_t mask, size_t available,
+                        size_t remaining)
+{
+    size_t count = (mask != 0u) ? (size_t)__builtin_ctz(mask) : available;
+
+    if (count > remaining)
+    {
+        count = remaining;
+    }
+    memcpy(dest, src, count);
+    return count;
+}
+
+SAFE_STRING_NO_ASAN
+static size_t copy_sse2(char *dest, const char *src, size_t limit)
+{
+    const __m128i zero     = _mm_setzero_si128();
+    size_t        misalign = (size_t)((uintptr_t)src & (SSE2_BLOCK - 1u));
+    const char   *block    = align_down(src, SSE2_BLOCK);
+
+    /* First block: ignore the bytes that precede src */
+    __m128i  chunk = _mm_load_si128((const __m128i *)(const void *)block);
+    uint32_t mask  = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)) >> misalign;
+    size_t   done  = SSE2_BLOCK - misalign;
+
+    if (mask != 0u || done >= limit)
+    {
+        return copy_tail(dest, src, mask, done, limit);
+    }
+    memcpy(dest, src, done);
+
+    /* Aligned body: whole blocks with no terminator and room to spare */
+    while (limit - done >= SSE2_BLOCK)
+    {
+        chunk = _mm_load_si128((const __m128i *)(const void *)(src + done));
+        mask  = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero));
+        if (mask != 0u)
+        {
+            return done + copy_tail(dest + done, src + done, mask, SSE2_BLOCK, limit - done);
+        }
+        _mm_storeu_si128((__m128i *)(void *)(dest + done), chunk);
+        done += SSE2_BLOCK;
+    }
+
+    if (done < limit)
+    {
+        chunk = _mm_load_si128((const __m128i *)(const void *)(src + done));
+        mask  = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero));
+        done += copy_tail(dest + done, src + done, mask, SSE2_BLOCK, limit - done);
+    }
+    return done;
+}
+
+SAFE_STRING_NO_ASAN
+__attribute__((target("avx2")))
+static size_t copy_avx2(char *dest, const char *src, size_t limit)
+{
+    const __m256i zero     = _mm256_setzero_si256();
+    size_t        misalign = (size_t)((uintptr_t)src & (AVX2_BLOCK - 1u));
+    const char   *block    = align_down(src, AVX2_BLOCK);
+
+    /* First block: ignore the bytes that precede src */
+    __m256i  chunk = _mm256_load_si256((const __m256i *)(const void *)block);
+    uint32_t mask  = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, zero)) >> misalign;
+    size_t   done  = AVX2_BLOCK - misalign;
+
+    if (mask != 0u || done >= limit)
+    {
+        return copy_tail(dest, src, mask, done, limit);
+    }
+    memcpy(dest, src, done);
+
+    /* Aligned body: whole blocks with no terminator and room to spare */
+    while (limit - done >= AVX2_BLOCK)
+    {
+        chunk = _mm256_load_si256((const __m256i *)(const void *)(src + done));
+        mask  = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, zero));
+        if (mask != 0u)
+        {
+            return done + copy_tail(dest + done, src + done, mask, AVX2_BLOCK, limit - done);
+        }
+        _mm256_storeu_si256((__m256i *)(void *)(dest + done), chunk);
+        done += AVX2_BLOCK;
+    }
+
+    if (done < limit)
+    {
+        chunk = _mm256_load_si256((const __m256i *)(const void *)(src + done));
+        mask  = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, zero));
+        done += copy_tail(dest + done, src + done, mask, AVX2_BLOCK, limit - done);
+    }
+    return done;
+}
+
+static void copy_batch_sse2(const StringCopyField *fields, size_t count, uint64_t *truncated)
+{
+    copy_fields(fields, count, truncated, copy_sse2);
+}
+
+__attribute__((target("avx2")))
+static void copy_batch_avx2(const StringCopyField *fields, size_t count, uint64_t *truncated)
+{
+    copy_fields(fields, count, truncated, copy_avx2);
+}
+
+static CopyKernel select_kernel(void)
+{
+    return __builtin_cpu_supports("avx2") ? copy_avx2 : copy_sse2;
+}
+
+static CopyBatch select_batch(void)
+{
+    return __builtin_cpu_supports("avx2") ? copy_batch_avx2 : copy_batch_sse2;
+}
+
+#else /* !SAFE_STRING_X86_SIMD */
+
+static size_t copy_portable(char *dest, const char *src, size_t limit)
+{
+    /* memchr stops at the first match, so at most limit bytes are read */
+    const char *end   = memchr(src, '\0', limit);
+    size_t      count = (end != NULL) ? (size_t)(end - src) : limit;
+
+    memcpy(dest, src, count);
+    return count;
+}
+
+static void copy_batch_portable(const StringCopyField *fields, size_t count, uint64_t *truncated)
+{
+    copy_fields(fields, count, truncated, copy_portable);
+}
+
+static CopyKernel select_kernel(void)
+{
+    return copy_portable;
+}
+
+static CopyBatch select_batch(void)
+{
+    return copy_batch_portable;
+}
+
+#endif /* SAFE_STRING_X86_SIMD */
+
+size_t safe_string_copy_kernel(char *dest, const char *src, size_t limit)
+{
+    if (limit == 0)
+    {
+        return 0;
+    }
+    return select_kernel()(dest, src, limit);
+}
+
+/**
+ * @brief Safely copy a string with bounds checking.
+ *
+ * Rule 20 Compliant: Returns status code
+ * Rule 21 Compliant: Uses bounded copy
+ * Rule 22 Compliant: Validates pointers
+ *
+ * @param dest Destination buffer
+ * @param dest_size Size of destination buffer
+ * @param src Source string
+ * @return Number of characters copied, or negative error code on error
+ */
+int safe_string_copy(char *dest, size_t dest_size, const char *src)
+{
+    /* Rule 22: Validate input pointers */
+    if (dest == NULL || src == NULL)
+    {
+        return ERROR_NULL_PARAM;
+    }
+
+    /* Rule 22: Validate buffer size */
+    if (dest_size == 0)
+    {
+        return ERROR_INVALID_INPUT;
+    }
+
+    /* Rule 21: Copy at most dest_size - 1 bytes (truncates longer input) */
+    size_t copied = safe_string_copy_kernel(dest, src, dest_size - 1);
+    dest[copied]  = '\0';  /* Ensure null termination */
+
+    return (int)copied;
+}
+
+/**
+ * @brief Copy a string, bounding all work by the destination size.
+ *
+ * Rule 20 Compliant: Returns status code, reports truncation
+ * Rule 21 Compliant: Reads at most dest_size bytes of src
+ * Rule 22 Compliant: Validates pointers
+ *
+ * @param dest Destination buffer
+ * @param dest_size Size of destination buffer
+ * @param src Source string
+ * @param out_length Optional; receives the number of characters copied
+ * @return ERROR_NONE, ERROR_TRUNCATED, or negative error code on error
+ */
+int safe_string_copy_bounded(char *dest, size_t dest_size, const char *src, size_t *out_length)
+{
+    /* Rule 22: Validate input pointers */
+    if (dest == NULL || src == NULL)
+    {
+        return ERROR_NULL_PARAM;
+    }
+
+    /* Rule 22: Validate buffer size */
+    if (dest_size == 0)
+    {
+        return ERROR_INVALID_INPUT;
+    }
+
+    size_t limit  = dest_size - 1;
+    size_t copied = safe_string_copy_kernel(dest, src, limit);
+    dest[copied]  = '\0';
+
+    if (out_length != NULL)
+    {
+        *out_length = copied;
+    }
+
+    /* A short copy stopped at the terminator. A full one has read limit
+     * bytes without finding it, so src[limit] is the only byte left to
+     * check and the total read stays within dest_size. */
+    if (copied < limit || src[limit] == '\0')
+    {
+        return ERROR_NONE;
+    }
+    return ERROR_TRUNCATED;
+}
+
+/**
+ * @brief Copy an array of string fields, validating all of them first.
+ *
+ * Rule 20 Compliant: Returns status code, truncation reported per field
+ * Rule 21 Compliant: Each copy is bounded by its dest_size
+ * Rule 22 Compliant: Validates every pointer before copying anything
+ *
+ * @param fields Fields to copy
+ * @param count Number of fields
+ * @param truncated Bitmask words, (count + 63) / 64 of them; bit i is set
+ *        when field i was truncated
+ * @return ERROR_NONE, or negative error code (nothing copied) on error
+ */
+int safe_string_copy_batch(const StringCopyField *fields, size_t count, uint64_t *truncated)
+{
+    /* Rule 22: Validate input pointers */
+    if ((fields == NULL || truncated == NULL) && count != 0)
+    {
+        return ERROR_NULL_PARAM;
+    }
+
+    /* Rule 22: Validate every field before writing to any destination */
+    for (size_t i = 0; i < count; i++)
+    {
+        if (fields[i].dest == NULL || fields[i].src == NULL)
+        {
+            return ERROR_NULL_PARAM;
+        }
+        if (fields[i].dest_size == 0)
+        {
+            return ERROR_INVALID_INPUT;
+        }
+    }
+
+    select_batch()(fields, count, truncated);
+    return ERROR_NONE;
+}
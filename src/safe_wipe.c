@@ -0,0 +1,112 @@
+/**
+ * @file safe_wipe.c
+ * @brief Secure memory wipe that the compiler cannot remove.
+ *
+ * A memset() right before free() is a dead store and optimizers may delete
+ * it. secure_wipe() follows the memset() with a compiler barrier that
+ * treats the buffer as read, so the stores must happen (explicit_bzero()
+ * semantics without depending on a libc that has it).
+ *
+ * Buffers of WIPE_STREAM_THRESHOLD bytes or more are cleared on x86-64 with
+ * non-temporal (streaming) SSE2 stores. These go straight to memory
+ * instead of evicting the working set from the cache to hold zeros nobody
+ * reads. They are followed by an sfence so they are globally visible
+ * before the memory is reused or freed.
+ *
+ * Rules demonstrated:
+ * - Rule 22: Prevent null pointer dereference
+ * - Rule 23: Clear sensitive data before release
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "safe_runtime.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(SAFE_RUNTIME_NO_SIMD)
+    #define SAFE_WIPE_STREAM 1
+    #include <emmintrin.h>
+#else
+    #define SAFE_WIPE_STREAM 0
+#endif
+
+/* Rule 41: Constants use UPPER_CASE */
+#define WIPE_STREAM_THRESHOLD (1024u * 1024u)
+#define WIPE_STREAM_BLOCK     64u  /* One cache line per iteration */
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/* The empty asm "reads" ptr and clobbers memory, so prior stores are live */
+#define WIPE_BARRIER(ptr) __asm__ __volatile__("" : : "r"(ptr) : "memory")
+
+#else
+
+/* Calling memset through a volatile pointer cannot be proven dead */
+static void *(*volatile g_wipe_memset)(void *, int, size_t) = memset;
+#define WIPE_BARRIER(ptr) ((void)(ptr))
+
+#endif
+
+#if SAFE_WIPE_STREAM
+
+/**
+ * @brief Zero a large buffer with streaming stores.
+ */
+static void wipe_stream(unsigned char *bytes, size_t size)
+{
+    /* Head: plain stores up to the first 16-byte boundary */
+    size_t head = (size_t)(-(uintptr_t)bytes & 15u);
+    memset(bytes, 0, head);
+    bytes += head;
+    size  -= head;
+
+    const __m128i zero = _mm_setzero_si128();
+    while (size >= WIPE_STREAM_BLOCK)
+    {
+        _mm_stream_si128((__m128i *)(void *)(bytes + 0), zero);
+        _mm_stream_si128((__m128i *)(void *)(bytes + 16), zero);
+        _mm_stream_si128((__m128i *)(void *)(bytes + 32), zero);
+        _mm_stream_si128((__m128i *)(void *)(bytes + 48), zero);
+        bytes += WIPE_STREAM_BLOCK;
+        size  -= WIPE_STREAM_BLOCK;
+    }
+
+    /* Order the streaming stores before anything that follows, e.g. free() */
+    _mm_sfence();
+    memset(bytes, 0, size);
+}
+
+#endif /* SAFE_WIPE_STREAM */
+
+/**
+ * @brief Zero memory in a way the compiler may not optimise away.
+ *
+ * Rule 22 Compliant: NULL or empty buffers are ignored
+ *
+ * @param ptr Buffer to wipe
+ * @param size Bytes to wipe
+ */
+void secure_wipe(void *ptr, size_t size)
+{
+    if (ptr == NULL || size == 0)
+    {
+        return;
+    }
+
+#if SAFE_WIPE_STREAM
+    if (size >= WIPE_STREAM_THRESHOLD)
+    {
+        wipe_stream(ptr, size);
+        WIPE_BARRIER(ptr);
+        return;
+    }
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    memset(ptr, 0, size);
+#else
+    (void)g_wipe_memset(ptr, 0, size);
+#endif
+    WIPE_BARRIER(ptr);
+}
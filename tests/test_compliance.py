@@ -13,6 +13,7 @@ Requirements:
 Run: pytest tests/test_compliance.py -v
 """
 
+import json
 import os
 import subprocess
 import shutil
@@ -177,6 +178,296 @@ class TestClangTidy:
         assert has_issues, "Expected violations.c to trigger warnings"
 
 
+# =============================================================================
+# compile_commands.json Generator Tests
+# =============================================================================
+
+requires_cmake = pytest.mark.skipif(
+    not command_exists("cmake"),
+    reason="cmake not installed"
+)
+
+
+def run_generator(project_dir, *args):
+    """Run generate-compile-commands.sh against a project directory."""
+    return subprocess.run(
+        ["bash", str(SCRIPTS_DIR / "generate-compile-commands.sh"),
+         str(project_dir), *args],
+        capture_output=True,
+        text=True,
+    )
+
+
+@requires_cmake
+class TestGenerateCompileCommandsCMake:
+    """Tests for the CMake path of generate-compile-commands.sh."""
+
+    @pytest.fixture
+    def cmake_project(self, tmp_path):
+        """Create a minimal CMake project."""
+        (tmp_path / "CMakeLists.txt").write_text(
+            "cmake_minimum_required(VERSION 3.10)\n"
+            "project(sample C)\n"
+            "add_library(sample sample.c)\n"
+        )
+        (tmp_path / "sample.c").write_text("int sample(void) { return 0; }\n")
+        return tmp_path
+
+    def test_reuses_configured_build_tree(self, cmake_project):
+        """Verify an unchanged build tree is reused without reconfiguring."""
+        first = run_generator(cmake_project)
+        assert first.returncode == 0, first.stderr
+        assert (cmake_project / "compile_commands.json").exists()
+
+        second = run_generator(cmake_project)
+        assert second.returncode == 0, second.stderr
+        assert "Reused compile_commands.json" in second.stdout
+
+    def test_reconfigures_after_cmakelists_change(self, cmake_project):
+        """Verify editing CMakeLists.txt invalidates the cached build tree."""
+        assert run_generator(cmake_project).returncode == 0
+
+        with open(cmake_project / "CMakeLists.txt", "a") as f:
+            f.write("# changed\n")
+
+        result = run_generator(cmake_project)
+        assert result.returncode == 0, result.stderr
+        assert "Generated compile_commands.json using CMake" in result.stdout
+
+    def test_ignores_other_build_trees(self, cmake_project):
+        """Verify reconfiguring a second build tree keeps the cache valid."""
+        assert run_generator(cmake_project).returncode == 0
+
+        other = cmake_project / "out"
+        subprocess.run(["cmake", "-S", str(cmake_project), "-B", str(other)],
+                       capture_output=True, check=True)
+        (other / "extra.cmake").write_text("# generated\n")
+
+        result = run_generator(cmake_project)
+        assert result.returncode == 0, result.stderr
+        assert "Reused compile_commands.json" in result.stdout
+
+    def test_symlink_mode(self, cmake_project):
+        """Verify --symlink links the database from build/."""
+        result = run_generator(cmake_project, "--symlink")
+        assert result.returncode == 0, result.stderr
+        assert (cmake_project / "compile_commands.json").is_symlink()
+
+
+class TestScanIncludes:
+    """Tests for the lexer-level include scanner."""
+
+    def run_scanner(self, project_dir, *args):
+        """Run scan-includes.sh and return the parsed edge list."""
+        result = subprocess.run(
+            ["bash", str(SCRIPTS_DIR / "scan-includes.sh"), str(project_dir), *args],
+            capture_output=True,
+            text=True,
+        )
+        assert result.returncode == 0, result.stderr
+        graph = (project_dir / "include_graph.tsv").read_text().splitlines()
+        return result, [tuple(line.split("\t")) for line in graph]
+
+    @pytest.fixture
+    def scan_project(self, tmp_path):
+        """Create a source file exercising comments and dead branches."""
+        for name in ("live", "dead", "commented", "else_branch"):
+            (tmp_path / f"{name}.h").write_text(
+                f"#ifndef {name.upper()}_H\n#define {name.upper()}_H\n#endif\n"
+            )
+        (tmp_path / "main.c").write_text(
+            "/* #include \"commented.h\" */\n"
+            "#include \"live.h\"\n"
+            "#if 0\n"
+            "#include \"dead.h\"\n"
+            "#else\n"
+            "#include \"else_branch.h\"\n"
+            "#endif\n"
+        )
+        return tmp_path
+
+    def test_skips_comments_and_if_zero(self, scan_project):
+        """Verify commented-out and #if 0 includes are not edges."""
+        _, edges = self.run_scanner(scan_project)
+        assert edges == [
+            ("./main.c", "./else_branch.h"),
+            ("./main.c", "./live.h"),
+        ]
+
+    def test_memoises_unchanged_files(self, scan_project):
+        """Verify a second scan lexes nothing when no file changed."""
+        self.run_scanner(scan_project)
+        result, _ = self.run_scanner(scan_project)
+        assert "Lexed 0 of 5 file(s)" in result.stdout
+
+    def test_warns_on_duplicate_include_guard(self, scan_project):
+        """Verify headers sharing an include guard are reported."""
+        (scan_project / "copy.h").write_text(
+            "#ifndef LIVE_H\n#define LIVE_H\n#endif\n"
+        )
+        result, _ = self.run_scanner(scan_project)
+        assert "duplicate include guard LIVE_H" in result.stdout
+
+    def test_scans_files_named_like_assignments(self, scan_project):
+        """Verify a path containing "=" is lexed, not read as an awk assignment."""
+        (scan_project / "a=b.c").write_text("#include \"live.h\"\n")
+        _, edges = self.run_scanner(scan_project)
+        assert ("./a=b.c", "./live.h") in edges
+
+    def test_identical_files_share_one_lex(self, scan_project):
+        """Verify copies across parallel batches are lexed once and all scanned."""
+        for index in range(300):
+            (scan_project / f"copy{index}.c").write_text("#include \"live.h\"\n")
+        result, edges = self.run_scanner(scan_project, "--jobs", "4")
+        assert "Lexed 6 of 305 file(s)" in result.stdout
+        assert sum(1 for edge in edges if edge[1] == "./live.h") == 301
+        assert not list((scan_project / ".cache").rglob("*.part"))
+
+
+class TestGenerateHeaderMap:
+    """Tests for the header-to-TU table written by the generator."""
+
+    @pytest.fixture
+    def header_project(self, tmp_path):
+        """Create a project with direct, transitive and orphan headers."""
+        (tmp_path / "src").mkdir()
+        (tmp_path / "include" / "sub").mkdir(parents=True)
+        (tmp_path / "src" / "b.c").write_text('#include "a.h"\n')
+        (tmp_path / "src" / "a.c").write_text('#include "a.h"\n')
+        (tmp_path / "include" / "a.h").write_text('#include "sub/c.h"\n')
+        (tmp_path / "include" / "sub" / "c.h").write_text("int c;\n")
+        (tmp_path / "include" / "orphan.h").write_text("int o;\n")
+        return tmp_path
+
+    def load_map(self, project_dir):
+        """Parse compile_headers.tsv into a header -> source dict."""
+        table = {}
+        for line in (project_dir / "compile_headers.tsv").read_text().splitlines():
+            header, source = line.split("\t")
+            table[header] = source
+        return table
+
+    def test_maps_headers_to_first_including_source(self, header_project):
+        """Verify direct and transitive headers map to one source file."""
+        result = run_generator(header_project)
+        assert result.returncode == 0, result.stderr
+
+        table = self.load_map(header_project)
+        root = str(header_project.resolve())
+        expected_source = f"{root}/src/a.c"
+        assert table[f"{root}/include/a.h"] == expected_source
+        assert table[f"{root}/include/sub/c.h"] == expected_source
+
+    def test_orphan_headers_are_not_mapped(self, header_project):
+        """Verify headers no source file includes are left out."""
+        assert run_generator(header_project).returncode == 0
+
+        table = self.load_map(header_project)
+        assert not any(h.endswith("orphan.h") for h in table)
+
+
+class TestGenerateStableDatabase:
+    """Tests for reproducible compile_commands.json output."""
+
+    @pytest.fixture
+    def source_project(self, tmp_path):
+        """Create a project with several source files."""
+        for name in ("zeta.c", "alpha.c", "mid.cpp"):
+            (tmp_path / name).write_text("int x;\n")
+        return tmp_path
+
+    def test_entries_sorted_by_file(self, source_project):
+        """Verify entries are emitted in sorted file order."""
+        assert run_generator(source_project).returncode == 0
+
+        entries = json.loads((source_project / "compile_commands.json").read_text())
+        files = [entry["file"] for entry in entries]
+        assert files == sorted(files)
+
+    def test_regeneration_is_byte_identical(self, source_project):
+        """Verify regenerating produces identical database and digests."""
+        assert run_generator(source_project).returncode == 0
+        database = (source_project / "compile_commands.json").read_text()
+        digests = (source_project / "compile_digests.tsv").read_text()
+
+        assert run_generator(source_project).returncode == 0
+        assert (source_project / "compile_commands.json").read_text() == database
+        assert (source_project / "compile_digests.tsv").read_text() == digests
+
+    def test_one_digest_per_entry(self, source_project):
+        """Verify compile_digests.tsv has one digest per database entry."""
+        assert run_generator(source_project).returncode == 0
+
+        entries = json.loads((source_project / "compile_commands.json").read_text())
+        rows = (source_project / "compile_digests.tsv").read_text().splitlines()
+        assert [row.split("\t")[0] for row in rows] == [e["file"] for e in entries]
+        assert all(len(row.split("\t")[1]) == 64 for row in rows)
+
+    def test_rejects_unknown_option(self, source_project):
+        """Verify an unknown option prints usage and fails without writing."""
+        result = run_generator(source_project, "--frobnicate")
+        assert result.returncode != 0
+        assert "Usage:" in result.stderr
+        assert not (source_project / "compile_commands.json").exists()
+
+
+# =============================================================================
+# Cross-TU Analysis Tests
+# =============================================================================
+
+requires_ctu_tools = pytest.mark.skipif(
+    not (command_exists("clang") and command_exists("clang-extdef-mapping")),
+    reason="clang or clang-extdef-mapping not installed"
+)
+
+
+def run_ctu(project_dir, *args):
+    """Run ctu-analyze.sh against a project directory."""
+    return subprocess.run(
+        ["bash", str(SCRIPTS_DIR / "ctu-analyze.sh"), str(project_dir), *args],
+        capture_output=True,
+        text=True,
+    )
+
+
+class TestCtuAnalyze:
+    """Tests for scripts/ctu-analyze.sh."""
+
+    def test_requires_compile_database(self, tmp_path):
+        """Verify a missing compile_commands.json is a setup error."""
+        result = run_ctu(tmp_path)
+        assert result.returncode == 1
+        assert "compile_commands.json not found" in result.stdout
+
+    @requires_ctu_tools
+    def test_detects_leak_across_files(self, tmp_path):
+        """Verify a leak through a callee in another file is reported."""
+        (tmp_path / "alloc.c").write_text(
+            "#include <stdlib.h>\n"
+            "char *make_buffer(void) { return malloc(16); }\n"
+        )
+        (tmp_path / "use.c").write_text(
+            "char *make_buffer(void);\n"
+            "int use(void) { char *p = make_buffer(); return p != 0; }\n"
+        )
+        assert run_generator(tmp_path).returncode == 0
+
+        result = run_ctu(tmp_path, "--jobs", "2")
+        assert result.returncode == 2, result.stdout
+        assert "use.c (critical issues)" in result.stdout
+
+    @requires_ctu_tools
+    def test_failed_translation_unit_is_not_a_pass(self, tmp_path):
+        """Verify a TU that does not compile fails instead of passing."""
+        (tmp_path / "broken.c").write_text("int broken(void) { return missing; }\n")
+        assert run_generator(tmp_path).returncode == 0
+
+        result = run_ctu(tmp_path)
+        assert result.returncode == 1, result.stdout
+        assert "could not be analyzed" in result.stdout
+        assert "PASS\x1b[0m: broken.c" not in result.stdout
+
+
 # =============================================================================
 # Severity Mapping Tests
 # =============================================================================
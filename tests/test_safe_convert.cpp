@@ -0,0 +1,99 @@
+/**
+ * @file test_safe_convert.cpp
+ * @brief Tests for the C++ side of safe_convert.h.
+ *
+ * Built only when a C++17 compiler is available. Most checks are
+ * static_asserts: checked_convert() is constexpr, so the range logic is
+ * verified at compile time; the rest run like test_safe_runtime.c.
+ */
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+#include "safe_convert.h"
+
+namespace
+{
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                            \
+    do                                                                         \
+    {                                                                          \
+        if (!(cond))                                                           \
+        {                                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                      \
+        }                                                                      \
+    } while (0)
+
+template <typename To, typename From>
+constexpr int convert(From value)
+{
+    To out{};
+    return safe_runtime::checked_convert(value, &out);
+}
+
+/* Integer to integer */
+static_assert(convert<int>(static_cast<short>(-5)) == ERROR_NONE);
+static_assert(convert<std::uint16_t>(std::int64_t{65535}) == ERROR_NONE);
+static_assert(convert<std::uint16_t>(std::int64_t{65536}) == ERROR_OVERFLOW);
+static_assert(convert<std::uint16_t>(std::int64_t{-1}) == ERROR_OVERFLOW);
+static_assert(convert<int>(static_cast<std::size_t>(INT_MAX)) == ERROR_NONE);
+static_assert(convert<int>(static_cast<std::size_t>(INT_MAX) + 1u) == ERROR_OVERFLOW);
+static_assert(convert<unsigned long>(-1) == ERROR_OVERFLOW);
+static_assert(convert<long long>(ULLONG_MAX) == ERROR_OVERFLOW);
+static_assert(convert<signed char>(-128) == ERROR_NONE);
+static_assert(convert<signed char>(-129) == ERROR_OVERFLOW);
+static_assert(convert<std::int64_t>(std::numeric_limits<std::uint32_t>::max()) == ERROR_NONE);
+
+/* Floating to integer truncates toward zero */
+static_assert(convert<std::int32_t>(2147483647.9) == ERROR_NONE);
+static_assert(convert<std::int32_t>(2147483648.0) == ERROR_OVERFLOW);
+static_assert(convert<std::int32_t>(-2147483648.9) == ERROR_NONE);
+static_assert(convert<std::int32_t>(-2147483649.0) == ERROR_OVERFLOW);
+static_assert(convert<unsigned char>(-0.9f) == ERROR_NONE);
+static_assert(convert<unsigned char>(-1.0f) == ERROR_OVERFLOW);
+static_assert(convert<long long>(9223372036854775808.0) == ERROR_OVERFLOW);
+static_assert(convert<long long>(-9223372036854775808.0) == ERROR_NONE);
+
+/* Floating narrowing and integer to floating */
+static_assert(convert<float>(1e300) == ERROR_OVERFLOW);
+static_assert(convert<float>(1.5) == ERROR_NONE);
+static_assert(convert<double>(3.25f) == ERROR_NONE);
+static_assert(convert<float>(ULLONG_MAX) == ERROR_NONE);
+
+void test_checked_convert_runtime()
+{
+    volatile double zero = 0.0;
+    int             out  = 7;
+
+    /* NaN and infinity are only produced at run time */
+    CHECK(safe_runtime::checked_convert(zero / zero, &out) == ERROR_OVERFLOW);
+    CHECK(safe_runtime::checked_convert(1.0 / zero, &out) == ERROR_OVERFLOW);
+    CHECK(out == 7);  /* Untouched on failure */
+
+    float narrowed = 0.0f;
+    CHECK(safe_runtime::checked_convert(1.0 / zero, &narrowed) == ERROR_NONE);
+
+    CHECK(safe_runtime::checked_convert(-42L, &out) == ERROR_NONE && out == -42);
+    CHECK(safe_runtime::checked_convert(1, static_cast<int *>(nullptr)) == ERROR_NULL_PARAM);
+}
+
+} /* namespace */
+
+int main()
+{
+    test_checked_convert_runtime();
+
+    if (g_failures != 0)
+    {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("All safe_convert C++ tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1815 @@
+/**
+ * @file test_safe_runtime.c
+ * @brief Unit tests for the safe_runtime library.
+ *
+ * Run: ctest --test-dir build (or build/test_safe_runtime directly)
+ *
+ * Each test function checks one behavior; CHECK records failures and the
+ * process exits non-zero if any check failed.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "safe_convert.h"
+#include "safe_runtime.h"
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                            \
+    do                                                                         \
+    {                                                                          \
+        if (!(cond))                                                           \
+        {                                                                      \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                      \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief Write content to a new temporary file.
+ *
+ * @param path Template buffer, replaced with the created file's path
+ * @return 0 on success, -1 on failure
+ */
+static int write_temp_file(char *path, const char *content, size_t length)
+{
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    ssize_t written = write(fd, content, length);
+    if (close(fd) != 0 || written != (ssize_t)length)
+    {
+        (void)unlink(path);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read a whole file into buffer (NUL-terminated) and count its lines.
+ */
+static size_t read_file_lines(int fd, char *buffer, size_t size)
+{
+    size_t  used  = 0;
+    size_t  lines = 0;
+    ssize_t got   = 0;
+
+    if (lseek(fd, 0, SEEK_SET) != 0)
+    {
+        return 0;
+    }
+    while (used < size - 1 && (got = read(fd, buffer + used, size - 1 - used)) > 0)
+    {
+        used += (size_t)got;
+    }
+    buffer[used] = '\0';
+    for (size_t i = 0; i < used; i++)
+    {
+        lines += (buffer[i] == '\n');
+    }
+    return lines;
+}
+
+/**
+ * @brief Map a readable page followed by an inaccessible guard page.
+ *
+ * @param page_out Receives the page size
+ * @return Address of the first guard byte, or NULL on failure
+ */
+static char *map_guarded_page(size_t *page_out)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0)
+    {
+        return NULL;
+    }
+
+    /* /dev/zero rather than MAP_ANONYMOUS, which POSIX does not define */
+    int fd = open("/dev/zero", O_RDWR);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    char *map = mmap(NULL, (size_t)page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    (void)close(fd);
+    if (map == MAP_FAILED)
+    {
+        return NULL;
+    }
+    if (mprotect(map + page, (size_t)page, PROT_NONE) != 0)
+    {
+        (void)munmap(map, (size_t)page * 2);
+        return NULL;
+    }
+    *page_out = (size_t)page;
+    return map + page;
+}
+
+static void unmap_guarded_page(char *guard, size_t page)
+{
+    CHECK(munmap(guard - page, page * 2) == 0);
+}
+
+/**
+ * @brief Return 1 if every byte is zero.
+ */
+static int all_zero(const unsigned char *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        if (bytes[i] != 0)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* ==========================================================================
+ * safe_string_copy
+ * ========================================================================== */
+
+static void test_safe_string_copy_fits(void)
+{
+    char dest[16];
+
+    CHECK(safe_string_copy(dest, sizeof(dest), "hello") == 5);
+    CHECK(strcmp(dest, "hello") == 0);
+}
+
+static void test_safe_string_copy_truncates(void)
+{
+    char dest[4];
+
+    CHECK(safe_string_copy(dest, sizeof(dest), "hello") == 3);
+    CHECK(strcmp(dest, "hel") == 0);
+}
+
+static void test_safe_string_copy_rejects_bad_params(void)
+{
+    char dest[4];
+
+    CHECK(safe_string_copy(NULL, sizeof(dest), "x") == ERROR_NULL_PARAM);
+    CHECK(safe_string_copy(dest, sizeof(dest), NULL) == ERROR_NULL_PARAM);
+    CHECK(safe_string_copy(dest, 0, "x") == ERROR_INVALID_INPUT);
+}
+
+static void test_safe_string_copy_matches_reference(void)
+{
+    /* Every source offset (alignment), length and destination size that
+     * exercises the head, body and tail paths of the vector kernels. */
+    char source[160];
+    char dest[160];
+
+    for (size_t offset = 0; offset < 32; offset++)
+    {
+        for (size_t length = 0; length < 100; length++)
+        {
+            memset(source, 'a', sizeof(source));
+            for (size_t k = 0; k < length; k++)
+            {
+                source[offset + k] = (char)('A' + (k % 26));
+            }
+            source[offset + length] = '\0';
+
+            for (size_t dest_size = 1; dest_size < 100; dest_size += 7)
+            {
+                size_t expected = length < dest_size ? length : dest_size - 1;
+
+                memset(dest, 'z', sizeof(dest));
+                CHECK(safe_string_copy(dest, dest_size, source + offset) == (int)expected);
+                CHECK(memcmp(dest, source + offset, expected) == 0);
+                CHECK(dest[expected] == '\0');
+                CHECK(dest[dest_size] == 'z');  /* Nothing written past dest_size */
+            }
+        }
+    }
+}
+
+static void test_safe_string_copy_at_page_end(void)
+{
+    /* A string ending on the last byte before an inaccessible page must be
+     * copied without touching the guard page. */
+    size_t page  = 0;
+    char  *guard = map_guarded_page(&page);
+    char   dest[64];
+
+    CHECK(guard != NULL);
+    if (guard == NULL)
+    {
+        return;
+    }
+    for (size_t length = 0; length < 40; length++)
+    {
+        char *src = guard - length - 1;
+
+        memset(src, 'q', length);
+        src[length] = '\0';
+        CHECK(safe_string_copy(dest, sizeof(dest), src) == (int)length);
+    }
+    unmap_guarded_page(guard, page);
+}
+
+static void test_safe_string_copy_bounded_reports_truncation(void)
+{
+    char   dest[8];
+    size_t length = 99;
+
+    CHECK(safe_string_copy_bounded(dest, sizeof(dest), "seven!!", &length) == ERROR_NONE);
+    CHECK(length == 7 && strcmp(dest, "seven!!") == 0);
+    CHECK(safe_string_copy_bounded(dest, sizeof(dest), "eight!!!", &length) == ERROR_TRUNCATED);
+    CHECK(length == 7 && strcmp(dest, "eight!!") == 0);
+    CHECK(safe_string_copy_bounded(dest, sizeof(dest), "", NULL) == ERROR_NONE);
+    CHECK(dest[0] == '\0');
+    CHECK(safe_string_copy_bounded(dest, 1, "x", &length) == ERROR_TRUNCATED);
+    CHECK(length == 0 && dest[0] == '\0');
+}
+
+static void test_safe_string_copy_bounded_rejects_bad_params(void)
+{
+    char dest[4];
+
+    CHECK(safe_string_copy_bounded(NULL, sizeof(dest), "x", NULL) == ERROR_NULL_PARAM);
+    CHECK(safe_string_copy_bounded(dest, sizeof(dest), NULL, NULL) == ERROR_NULL_PARAM);
+    CHECK(safe_string_copy_bounded(dest, 0, "x", NULL) == ERROR_INVALID_INPUT);
+}
+
+static void test_safe_string_copy_bounded_reads_at_most_dest_size(void)
+{
+    /* An unterminated source of exactly dest_size bytes ending at a guard
+     * page: any read past dest_size bytes would fault. */
+    size_t page  = 0;
+    char  *guard = map_guarded_page(&page);
+    char   dest[48];
+
+    CHECK(guard != NULL);
+    if (guard == NULL)
+    {
+        return;
+    }
+    for (size_t dest_size = 1; dest_size <= sizeof(dest); dest_size++)
+    {
+        char  *src    = guard - dest_size;
+        size_t length = 0;
+
+        memset(src, 'u', dest_size);
+        CHECK(safe_string_copy_bounded(dest, dest_size, src, &length) == ERROR_TRUNCATED);
+        CHECK(length == dest_size - 1);
+        CHECK(dest[length] == '\0');
+    }
+    unmap_guarded_page(guard, page);
+}
+
+static void test_safe_string_copy_batch_sets_truncation_bits(void)
+{
+    char            dest[70][4];
+    StringCopyField fields[70];
+    uint64_t        truncated[2] = {~0ull, ~0ull};
+
+    for (size_t i = 0; i < 70; i++)
+    {
+        fields[i].dest      = dest[i];
+        fields[i].dest_size = sizeof(dest[i]);
+        fields[i].src       = (i % 3 == 0) ? "long" : "abc";
+    }
+
+    CHECK(safe_string_copy_batch(fields, 70, truncated) == ERROR_NONE);
+    for (size_t i = 0; i < 70; i++)
+    {
+        int bit = (int)((truncated[i / 64] >> (i % 64)) & 1u);
+
+        CHECK(bit == (i % 3 == 0));
+        CHECK(strcmp(dest[i], (i % 3 == 0) ? "lon" : "abc") == 0);
+    }
+    CHECK((truncated[1] >> 6) == 0);  /* Bits past count stay clear */
+}
+
+static void test_safe_string_copy_batch_validates_before_copying(void)
+{
+    char            first[8] = "unset";
+    char            second[8];
+    StringCopyField fields[2] = {
+        {first, sizeof(first), "new"},
+        {second, 0, "x"},
+    };
+    uint64_t truncated = 0;
+
+    CHECK(safe_string_copy_batch(fields, 2, &truncated) == ERROR_INVALID_INPUT);
+    CHECK(strcmp(first, "unset") == 0);
+
+    fields[1].dest_size = sizeof(second);
+    fields[1].src       = NULL;
+    CHECK(safe_string_copy_batch(fields, 2, &truncated) == ERROR_NULL_PARAM);
+    CHECK(safe_string_copy_batch(NULL, 1, &truncated) == ERROR_NULL_PARAM);
+    CHECK(safe_string_copy_batch(fields, 2, NULL) == ERROR_NULL_PARAM);
+    CHECK(safe_string_copy_batch(NULL, 0, NULL) == ERROR_NONE);
+}
+
+/* ==========================================================================
+ * read_config_file
+ * ========================================================================== */
+
+static void test_read_config_file_reads_content(void)
+{
+    char path[] = "/tmp/test_safe_runtime_XXXXXX";
+    char buffer[32];
+
+    if (write_temp_file(path, "key=value\n", 10) != 0)
+    {
+        CHECK(!"could not create temp file");
+        return;
+    }
+    CHECK(read_config_file(path, buffer, sizeof(buffer)) == 10);
+    CHECK(strcmp(buffer, "key=value\n") == 0);
+    (void)unlink(path);
+}
+
+static void test_read_config_file_truncates_to_buffer(void)
+{
+    char path[] = "/tmp/test_safe_runtime_XXXXXX";
+    char buffer[4];
+
+    if (write_temp_file(path, "abcdefgh", 8) != 0)
+    {
+        CHECK(!"could not create temp file");
+        return;
+    }
+    CHECK(read_config_file(path, buffer, sizeof(buffer)) == 3);
+    CHECK(strcmp(buffer, "abc") == 0);
+    (void)unlink(path);
+}
+
+static void test_read_config_file_missing_file(void)
+{
+    char buffer[8];
+
+    CHECK(read_config_file("/nonexistent/safe_runtime.cfg", buffer, sizeof(buffer)) ==
+          ERROR_FILE_OPEN);
+    CHECK(read_config_file(NULL, buffer, sizeof(buffer)) == ERROR_NULL_PARAM);
+    CHECK(read_config_file("x", buffer, 0) == ERROR_INVALID_INPUT);
+}
+
+static void test_map_config_file_maps_content(void)
+{
+    char       path[] = "/tmp/test_safe_runtime_XXXXXX";
+    ConfigView view   = {NULL, 0};
+
+    if (write_temp_file(path, "key=value\nmode=fast\n", 20) != 0)
+    {
+        CHECK(!"could not create temp file");
+        return;
+    }
+    CHECK(map_config_file(path, &view) == ERROR_NONE);
+    CHECK(view.size == 20);
+    CHECK(view.data != NULL && memcmp(view.data, "key=value\nmode=fast\n", 20) == 0);
+
+    unmap_config_file(&view);
+    CHECK(view.data == NULL && view.size == 0);
+    unmap_config_file(&view);  /* Releasing twice is a no-op */
+    unmap_config_file(NULL);
+    (void)unlink(path);
+}
+
+static void test_map_config_file_empty_file(void)
+{
+    char       path[] = "/tmp/test_safe_runtime_XXXXXX";
+    ConfigView view   = {NULL, 0};
+
+    if (write_temp_file(path, "", 0) != 0)
+    {
+        CHECK(!"could not create temp file");
+        return;
+    }
+    CHECK(map_config_file(path, &view) == ERROR_NONE);
+    CHECK(view.data != NULL && view.size == 0);
+    unmap_config_file(&view);
+    (void)unlink(path);
+}
+
+static void test_map_config_file_errors(void)
+{
+    ConfigView view = {"stale", 5};
+
+    CHECK(map_config_file("/nonexistent/safe_runtime.cfg", &view) == ERROR_FILE_OPEN);
+    CHECK(view.data == NULL && view.size == 0);
+    CHECK(map_config_file("/tmp", &view) == ERROR_FILE_READ);
+    CHECK(map_config_file(NULL, &view) == ERROR_NULL_PARAM);
+    CHECK(map_config_file("x", NULL) == ERROR_NULL_PARAM);
+}
+
+typedef struct ChunkStats
+{
+    size_t calls;
+    size_t bytes;
+    size_t max_length;
+    size_t stop_after;  /* Stop with ERROR_INVALID_INPUT after this many calls */
+    char   last;
+} ChunkStats;
+
+static int count_chunk(const char *chunk, size_t length, void *context)
+{
+    ChunkStats *stats = context;
+
+    stats->calls++;
+    stats->bytes     += length;
+    stats->max_length = length > stats->max_length ? length : stats->max_length;
+    stats->last       = chunk[length - 1];
+    return (stats->calls == stats->stop_after) ? ERROR_INVALID_INPUT : ERROR_NONE;
+}
+
+static void test_read_config_chunks_streams_whole_file(void)
+{
+    char       path[] = "/tmp/test_safe_runtime_XXXXXX";
+    char       content[10000];
+    char       chunk[1024];
+    ChunkStats stats = {0, 0, 0, 0, 0};
+    uint64_t   total = 0;
+
+    memset(content, 'c', sizeof(content));
+    content[sizeof(content) - 1] = 'z';
+    if (write_temp_file(path, content, sizeof(content)) != 0)
+    {
+        CHECK(!"could not create temp file");
+        return;
+    }
+
+    CHECK(read_config_chunks(path, chunk, sizeof(chunk), count_chunk, &stats, &total) ==
+          ERROR_NONE);
+    CHECK(total == sizeof(content));
+    CHECK(stats.bytes == sizeof(content));
+    CHECK(stats.calls == 10);  /* 9 full chunks and a 784-byte tail */
+    CHECK(stats.max_length == sizeof(chunk));
+    CHECK(stats.last == 'z');
+
+    /* The callback can stop the stream; its code is returned */
+    stats = (ChunkStats){0, 0, 0, 2, 0};
+    CHECK(read_config_chunks(path, chunk, sizeof(chunk), count_chunk, &stats, &total) ==
+          ERROR_INVALID_INPUT);
+    CHECK(stats.calls == 2 && total == 2 * sizeof(chunk));
+    (void)unlink(path);
+}
+
+static void test_config_reader_iterates(void)
+{
+    char         path[] = "/tmp/test_safe_runtime_XXXXXX";
+    char         chunk[4];
+    ConfigReader reader;
+    size_t       length = 0;
+
+    if (write_temp_file(path, "abcdefghij", 10) != 0)
+    {
+        CHECK(!"could not create temp file");
+        return;
+    }
+    CHECK(config_reader_open(&reader, path) == ERROR_NONE);
+    CHECK(config_reader_next(&reader, chunk, sizeof(chunk), &length) == ERROR_NONE);
+    CHECK(length == 4 && memcmp(chunk, "abcd", 4) == 0);
+    CHECK(config_reader_next(&reader, chunk, sizeof(chunk), &length) == ERROR_NONE);
+    CHECK(length == 4 && memcmp(chunk, "efgh", 4) == 0);
+    CHECK(config_reader_next(&reader, chunk, sizeof(chunk), &length) == ERROR_NONE);
+    CHECK(length == 2 && memcmp(chunk, "ij", 2) == 0);
+    CHECK(config_reader_next(&reader, chunk, sizeof(chunk), &length) == ERROR_NONE);
+    CHECK(length == 0);
+    CHECK(reader.total == 10);
+    CHECK(config_reader_next(&reader, chunk, 0, &length) == ERROR_INVALID_INPUT);
+
+    config_reader_close(&reader);
+    CHECK(reader.file == NULL);
+    config_reader_close(&reader);  /* Closing twice is a no-op */
+    CHECK(config_reader_next(&reader, chunk, sizeof(chunk), &length) == ERROR_NULL_PARAM);
+    (void)unlink(path);
+}
+
+static void test_config_reader_errors(void)
+{
+    ConfigReader reader;
+    char         chunk[8];
+    uint64_t     total = 99;
+    ChunkStats   stats = {0, 0, 0, 0, 0};
+
+    CHECK(config_reader_open(&reader, "/nonexistent/safe_runtime.cfg") == ERROR_FILE_OPEN);
+    CHECK(reader.file == NULL);
+    CHECK(config_reader_open(&reader, NULL) == ERROR_NULL_PARAM);
+    CHECK(config_reader_open(NULL, "x") == ERROR_NULL_PARAM);
+    CHECK(read_config_chunks("/nonexistent/safe_runtime.cfg", chunk, sizeof(chunk), count_chunk,
+                             &stats, &total) == ERROR_FILE_OPEN);
+    CHECK(total == 0 && stats.calls == 0);
+    CHECK(read_config_chunks("x", chunk, sizeof(chunk), NULL, NULL, NULL) == ERROR_NULL_PARAM);
+    CHECK(read_config_chunks("x", chunk, 0, count_chunk, &stats, NULL) == ERROR_INVALID_INPUT);
+}
+
+/**
+ * @brief Replace a file's content in place (same inode) and set its mtime.
+ */
+static int rewrite_file(const char *path, const char *content, size_t length, time_t mtime)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    size_t written = fwrite(content, 1, length, file);
+    if (fclose(file) != 0 || written != length)
+    {
+        return -1;
+    }
+    struct timespec times[2] = {{mtime, 0}, {mtime, 0}};
+    return utimensat(AT_FDCWD, path, times, 0);
+}
+
+static void test_read_config_file_cached_hits_and_revalidates(void)
+{
+    char     path[] = "/tmp/test_safe_runtime_XXXXXX";
+    char     buffer[32];
+    uint64_t hits   = 0;
+    uint64_t misses = 0;
+
+    if (write_temp_file(path, "v=1\n", 4) != 0)
+    {
+        CHECK(!"could not create temp file");
+        return;
+    }
+    config_cache_clear();
+
+    CHECK(read_config_file_cached(path, buffer, sizeof(buffer)) == 4);
+    CHECK(strcmp(buffer, "v=1\n") == 0);
+    CHECK(read_config_file_cached(path, buffer, sizeof(buffer)) == 4);
+    CHECK(strcmp(buffer, "v=1\n") == 0);
+    config_cache_stats(&hits, &misses);
+    CHECK(hits == 1 && misses == 1);
+
+    /* Same size, new mtime: must be re-read */
+    CHECK(rewrite_file(path, "v=2\n", 4, 1000000) == 0);
+    CHECK(read_config_file_cached(path, buffer, sizeof(buffer)) == 4);
+    CHECK(strcmp(buffer, "v=2\n") == 0);
+
+    /* New size, same mtime: must be re-read */
+    CHECK(rewrite_file(path, "v=33\n", 5, 1000000) == 0);
+    CHECK(read_config_file_cached(path, buffer, sizeof(buffer)) == 5);
+    CHECK(strcmp(buffer, "v=33\n") == 0);
+
+    /* Cached hits truncate to the caller's buffer like read_config_file */
+    CHECK(read_config_file_cached(path, buffer, 3) == 2);
+    CHECK(strcmp(buffer, "v=") == 0);
+    config_cache_stats(&hits, &misses);
+    CHECK(hits == 2 && misses == 3);
+
+    config_cache_clear();
+    config_cache_stats(&hits, &misses);
+    CHECK(hits == 0 && misses == 0);
+    (void)unlink(path);
+}
+
+static void test_read_config_file_cached_errors(void)
+{
+    char buffer[8];
+
+    CHECK(read_config_file_cached("/nonexistent/safe_runtime.cfg", buffer, sizeof(buffer)) ==
+          ERROR_FILE_OPEN);
+    CHECK(read_config_file_cached(NULL, buffer, sizeof(buffer)) == ERROR_NULL_PARAM);
+    CHECK(read_config_file_cached("x", buffer, 0) == ERROR_INVALID_INPUT);
+}
+
+typedef struct CachedReadJob
+{
+    const char *path;
+    int         failures;
+} CachedReadJob;
+
+static void *cached_read_worker(void *arg)
+{
+    CachedReadJob *job = arg;
+    char           buffer[64];
+
+    for (int i = 0; i < 2000; i++)
+    {
+        if (read_config_file_cached(job->path, buffer, sizeof(buffer)) != 11 ||
+            strcmp(buffer, "shared=yes\n") != 0)
+        {
+            job->failures++;
+        }
+    }
+    return NULL;
+}
+
+static void test_read_config_file_cached_concurrent(void)
+{
+    char          path[] = "/tmp/test_safe_runtime_XXXXXX";
+    pthread_t     threads[4];
+    CachedReadJob jobs[4];
+
+    if (write_temp_file(path, "shared=yes\n", 11) != 0)
+    {
+        CHECK(!"could not create temp file");
+        return;
+    }
+    for (size_t i = 0; i < 4; i++)
+    {
+        jobs[i] = (CachedReadJob){path, 0};
+        CHECK(pthread_create(&threads[i], NULL, cached_read_worker, &jobs[i]) == 0);
+    }
+    for (size_t i = 0; i < 4; i++)
+    {
+        CHECK(pthread_join(threads[i], NULL) == 0);
+        CHECK(jobs[i].failures == 0);
+    }
+    config_cache_clear();
+    (void)unlink(path);
+}
+
+#define BATCH_LOAD_FILES 150  /* Spans several io_uring batches */
+
+/**
+ * @brief Load BATCH_LOAD_FILES files plus a missing path and a directory.
+ */
+static void check_load_config_files(void)
+{
+    char        dir[] = "/tmp/test_safe_runtime_XXXXXX";
+    char        names[BATCH_LOAD_FILES][64];
+    const char *paths[BATCH_LOAD_FILES + 2];
+    FileData   *files[BATCH_LOAD_FILES + 2];
+    int         status[BATCH_LOAD_FILES + 2];
+
+    if (mkdtemp(dir) == NULL)
+    {
+        CHECK(!"could not create temp dir");
+        return;
+    }
+    for (size_t i = 0; i < BATCH_LOAD_FILES; i++)
+    {
+        char content[32];
+        int  length = snprintf(content, sizeof(content), "file=%zu\n", i);
+
+        (void)snprintf(names[i], sizeof(names[i]), "%s/%zu.cfg", dir, i);
+        CHECK(rewrite_file(names[i], content, (size_t)length, 1000000) == 0);
+        paths[i] = names[i];
+    }
+    paths[BATCH_LOAD_FILES]     = "/nonexistent/safe_runtime.cfg";
+    paths[BATCH_LOAD_FILES + 1] = dir;
+
+    CHECK(load_config_files(paths, BATCH_LOAD_FILES + 2, files, status) == ERROR_FILE_OPEN);
+    for (size_t i = 0; i < BATCH_LOAD_FILES; i++)
+    {
+        char expected[32];
+        int  length = snprintf(expected, sizeof(expected), "file=%zu\n", i);
+
+        CHECK(status[i] == ERROR_NONE);
+        CHECK(files[i] != NULL && files[i]->size == (size_t)length);
+        CHECK(files[i] != NULL && strcmp(files[i]->content, expected) == 0);
+        destroy_file_data(&files[i]);
+        (void)unlink(names[i]);
+    }
+    CHECK(status[BATCH_LOAD_FILES] == ERROR_FILE_OPEN && files[BATCH_LOAD_FILES] == NULL);
+    CHECK(status[BATCH_LOAD_FILES + 1] == ERROR_FILE_READ && files[BATCH_LOAD_FILES + 1] == NULL);
+
+    /* All good: ERROR_NONE, and out_status is optional */
+    CHECK(load_config_files(paths, 0, files, NULL) == ERROR_NONE);
+    (void)rmdir(dir);
+}
+
+static void test_load_config_files(void)
+{
+    check_load_config_files();
+
+    /* Same results from the thread-pool fallback */
+    CHECK(setenv("SAFE_RUNTIME_NO_IO_URING", "1", 1) == 0);
+    check_load_config_files();
+    CHECK(unsetenv("SAFE_RUNTIME_NO_IO_URING") == 0);
+}
+
+static void test_load_config_files_large(void)
+{
+    size_t      length  = (3u << 20) + 5;  /* Odd size, several MiB */
+    char       *content = malloc(length);
+    char        path[]  = "/tmp/test_safe_runtime_XXXXXX";
+    const char *paths[] = {path};
+    FileData   *files[1];
+    int         status[1];
+
+    CHECK(content != NULL);
+    if (content == NULL)
+    {
+        return;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        content[i] = (char)('a' + i % 26);
+    }
+    if (write_temp_file(path, content, length) != 0)
+    {
+        CHECK(!"could not create temp file");
+        free(content);
+        return;
+    }
+
+    /* The whole file arrives, through either path */
+    for (int round = 0; round < 2; round++)
+    {
+        CHECK(load_config_files(paths, 1, files, status) == ERROR_NONE);
+        CHECK(files[0] != NULL && files[0]->size == length);
+        CHECK(files[0] != NULL && memcmp(files[0]->content, content, length) == 0);
+        destroy_file_data(&files[0]);
+        CHECK(setenv("SAFE_RUNTIME_NO_IO_URING", "1", 1) == 0);
+    }
+    CHECK(unsetenv("SAFE_RUNTIME_NO_IO_URING") == 0);
+    (void)unlink(path);
+    free(content);
+}
+
+static void test_load_config_files_errors(void)
+{
+    const char *paths[2] = {"x", NULL};
+    FileData   *files[2];
+
+    CHECK(load_config_files(NULL, 1, files, NULL) == ERROR_NULL_PARAM);
+    CHECK(load_config_files(paths, 1, NULL, NULL) == ERROR_NULL_PARAM);
+    CHECK(load_config_files(paths, 2, files, NULL) == ERROR_NULL_PARAM);
+    CHECK(load_config_files(NULL, 0, NULL, NULL) == ERROR_NONE);
+}
+
+/* ==========================================================================
+ * process_data
+ * ========================================================================== */
+
+static void test_process_data(void)
+{
+    char long_input[300];
+    char expected[320];
+    char text[600];
+    char path[] = "/tmp/test_safe_runtime_XXXXXX";
+
+    CHECK(process_data("Hello from tests") == ERROR_NONE);
+    CHECK(process_data(NULL) == ERROR_NULL_PARAM);
+
+    /* Capture stdout: input longer than the buffer is cut to 255 bytes */
+    memset(long_input, 'x', sizeof(long_input) - 1);
+    long_input[sizeof(long_input) - 1] = '\0';
+    int fd    = mkstemp(path);
+    int saved = (fd >= 0 && fflush(stdout) == 0) ? dup(STDOUT_FILENO) : -1;
+    CHECK(saved >= 0);
+    if (saved < 0 || dup2(fd, STDOUT_FILENO) < 0)
+    {
+        if (fd >= 0)
+        {
+            (void)close(fd);
+            (void)unlink(path);
+        }
+        if (saved >= 0)
+        {
+            (void)close(saved);
+        }
+        return;
+    }
+    int full  = process_data(long_input);
+    long_input[255] = '\0';  /* Exactly what fits */
+    int exact = process_data(long_input);
+    (void)fflush(stdout);
+    (void)dup2(saved, STDOUT_FILENO);
+    (void)close(saved);
+    (void)unlink(path);
+
+    CHECK(full == ERROR_NONE && exact == ERROR_NONE);
+    (void)snprintf(expected, sizeof(expected), "Processed: %s\n", long_input);
+    CHECK(read_file_lines(fd, text, sizeof(text)) == 2);
+    CHECK(strlen(text) == 2 * strlen(expected));
+    CHECK(strncmp(text, expected, strlen(expected)) == 0);
+    CHECK(strcmp(text + strlen(expected), expected) == 0);
+    (void)close(fd);
+}
+
+static void test_process_data_batch(void)
+{
+    const char *inputs[] = {"alpha", NULL, "", "a somewhat longer input"};
+    const char *expected = "Processed: alpha\nProcessed: \nProcessed: a somewhat longer input\n";
+    int         status[4];
+    char        text[512];
+    char        small[5];
+    char        path[] = "/tmp/test_safe_runtime_XXXXXX";
+    int         fd     = mkstemp(path);
+
+    CHECK(fd >= 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    (void)unlink(path);
+
+    /* Internal buffer: one write, NULL entries skipped and reported */
+    CHECK(process_data_batch(fd, inputs, 4, NULL, 0, status) == ERROR_NULL_PARAM);
+    CHECK(status[0] == ERROR_NONE && status[1] == ERROR_NULL_PARAM);
+    CHECK(status[2] == ERROR_NONE && status[3] == ERROR_NONE);
+    CHECK(read_file_lines(fd, text, sizeof(text)) == 3 && strcmp(text, expected) == 0);
+
+    /* A buffer smaller than one line gives the same bytes over more writes */
+    CHECK(ftruncate(fd, 0) == 0 && lseek(fd, 0, SEEK_SET) == 0);
+    CHECK(process_data_batch(fd, inputs, 4, small, sizeof(small), NULL) == ERROR_NULL_PARAM);
+    CHECK(read_file_lines(fd, text, sizeof(text)) == 3 && strcmp(text, expected) == 0);
+    CHECK(process_data_batch(fd, inputs + 2, 2, small, sizeof(small), NULL) == ERROR_NONE);
+
+    /* Long inputs are cut at 255 bytes, as process_data() does */
+    char        long_input[300];
+    const char *long_inputs[] = {long_input};
+    memset(long_input, 'x', sizeof(long_input) - 1);
+    long_input[sizeof(long_input) - 1] = '\0';
+    CHECK(ftruncate(fd, 0) == 0 && lseek(fd, 0, SEEK_SET) == 0);
+    CHECK(process_data_batch(fd, long_inputs, 1, NULL, 0, NULL) == ERROR_NONE);
+    CHECK(read_file_lines(fd, text, sizeof(text)) == 1);
+    CHECK(strlen(text) == strlen("Processed: \n") + 255);
+    (void)close(fd);
+
+    /* Failed writes are charged to the inputs they held */
+    fd = open("/dev/null", O_RDONLY);
+    CHECK(fd >= 0);
+    if (fd >= 0)
+    {
+        CHECK(process_data_batch(fd, inputs, 4, NULL, 0, status) == ERROR_FILE_WRITE);
+        CHECK(status[0] == ERROR_FILE_WRITE && status[1] == ERROR_NULL_PARAM);
+        CHECK(status[3] == ERROR_FILE_WRITE);
+        (void)close(fd);
+    }
+
+    CHECK(process_data_batch(1, NULL, 1, NULL, 0, NULL) == ERROR_NULL_PARAM);
+    CHECK(process_data_batch(-1, inputs, 1, NULL, 0, NULL) == ERROR_INVALID_INPUT);
+    CHECK(process_data_batch(1, inputs, 1, small, 0, NULL) == ERROR_INVALID_INPUT);
+    CHECK(process_data_batch(1, NULL, 0, NULL, 0, NULL) == ERROR_NONE);
+}
+
+/* ==========================================================================
+ * convert_long_to_int
+ * ========================================================================== */
+
+static void test_convert_long_to_int(void)
+{
+    int out = 0;
+
+    CHECK(convert_long_to_int(42L, &out) == ERROR_NONE);
+    CHECK(out == 42);
+    CHECK(convert_long_to_int((long)INT_MIN, &out) == ERROR_NONE);
+    CHECK(out == INT_MIN);
+    CHECK(convert_long_to_int(1L, NULL) == ERROR_NULL_PARAM);
+#if LONG_MAX > INT_MAX
+    CHECK(convert_long_to_int((long)INT_MAX + 1L, &out) == ERROR_OVERFLOW);
+#endif
+}
+
+static void test_convert_long_array_to_int(void)
+{
+    enum { COUNT = 37 };  /* Odd: exercises vector blocks and the tail */
+    long   values[COUNT];
+    int    out[COUNT];
+    size_t index = 0;
+
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        values[i] = (i % 2 == 0) ? (long)(i * 1000003u) : -(long)(i * 7919u);
+    }
+    values[3]  = INT_MAX;
+    values[10] = INT_MIN;
+    memset(out, 0, sizeof(out));
+    CHECK(convert_long_array_to_int(values, out, COUNT, &index) == ERROR_NONE);
+    CHECK(index == COUNT);
+    int matches = 1;
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        matches &= (out[i] == (int)values[i]);
+    }
+    CHECK(matches);
+
+#if LONG_MAX > INT_MAX
+    /* The first bad index is reported wherever it falls; nothing after it
+     * is written */
+    long bad[] = {(long)INT_MAX + 1L, (long)INT_MIN - 1L, LONG_MAX, LONG_MIN,
+                  0x100000000L};
+    for (size_t at = 0; at < COUNT; at++)
+    {
+        long saved = values[at];
+
+        values[at] = bad[at % (sizeof(bad) / sizeof(bad[0]))];
+        memset(out, 0x55, sizeof(out));
+        CHECK(convert_long_array_to_int(values, out, COUNT, &index) == ERROR_OVERFLOW);
+        CHECK(index == at);
+        CHECK(at == 0 || out[at - 1] == (int)values[at - 1]);
+        CHECK(out[at] == 0x55555555);
+        values[at] = saved;
+    }
+
+    /* In place: the ints overwrite the front of the long array */
+    long inplace[COUNT];
+    memcpy(inplace, values, sizeof(inplace));
+    CHECK(convert_long_array_to_int(inplace, (int *)(void *)inplace, COUNT, NULL) ==
+          ERROR_NONE);
+    int narrowed[COUNT];
+    memcpy(narrowed, inplace, sizeof(narrowed));
+    matches = 1;
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        matches &= (narrowed[i] == (int)values[i]);
+    }
+    CHECK(matches);
+#endif
+
+    CHECK(convert_long_array_to_int(NULL, out, 1, &index) == ERROR_NULL_PARAM);
+    CHECK(convert_long_array_to_int(values, NULL, 1, &index) == ERROR_NULL_PARAM);
+    CHECK(convert_long_array_to_int(NULL, NULL, 0, &index) == ERROR_NONE && index == 0);
+}
+
+static void test_safe_convert_generic(void)
+{
+    int            i  = 0;
+    uint16_t       u  = 7;
+    int32_t        s  = 0;
+    unsigned char  uc = 0;
+    float          f  = 0.0f;
+    double         d  = 0.0;
+    long long      ll = 0;
+    unsigned long  ul = 0;
+
+    /* Widening never fails */
+    CHECK(SAFE_CONVERT((short)-5, &i) == ERROR_NONE && i == -5);
+    CHECK(SAFE_CONVERT((unsigned char)200, &ll) == ERROR_NONE && ll == 200);
+
+    /* Integer narrowing at the edges */
+    CHECK(SAFE_CONVERT((int64_t)65535, &u) == ERROR_NONE && u == 65535);
+    CHECK(SAFE_CONVERT((int64_t)65536, &u) == ERROR_OVERFLOW && u == 65535);
+    CHECK(SAFE_CONVERT((int64_t)-1, &u) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT((size_t)INT_MAX, &i) == ERROR_NONE && i == INT_MAX);
+    CHECK(SAFE_CONVERT((size_t)INT_MAX + 1u, &i) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT(-1, &ul) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT(ULLONG_MAX, &ll) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT(LLONG_MIN, &ll) == ERROR_NONE && ll == LLONG_MIN);
+    CHECK(SAFE_CONVERT(256, &uc) == ERROR_OVERFLOW && uc == 0);
+
+    /* Floating to integer truncates toward zero and rejects NaN/inf */
+    CHECK(SAFE_CONVERT(2147483647.9, &s) == ERROR_NONE && s == INT32_MAX);
+    CHECK(SAFE_CONVERT(2147483648.0, &s) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT(-2147483648.9, &s) == ERROR_NONE && s == INT32_MIN);
+    CHECK(SAFE_CONVERT(-2147483649.0, &s) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT(-0.9, &uc) == ERROR_NONE && uc == 0);
+    CHECK(SAFE_CONVERT(-1.0f, &uc) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT(9223372036854775808.0, &ll) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT(-9223372036854775808.0, &ll) == ERROR_NONE && ll == LLONG_MIN);
+    CHECK(SAFE_CONVERT(18446744073709549568.0, &ul) == ERROR_NONE);  /* Largest below 2^64 */
+    d = 0.0;
+    CHECK(SAFE_CONVERT(d / d, &i) == ERROR_OVERFLOW);  /* NaN */
+    CHECK(SAFE_CONVERT(1.0 / d, &i) == ERROR_OVERFLOW);  /* Infinity */
+
+    /* Floating narrowing rejects finite overflow only */
+    CHECK(SAFE_CONVERT(1e300, &f) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT(-1e300, &f) == ERROR_OVERFLOW);
+    CHECK(SAFE_CONVERT(1.5, &f) == ERROR_NONE && f == 1.5f);
+    CHECK(SAFE_CONVERT(1.0 / d, &f) == ERROR_NONE && f > FLT_MAX);
+    CHECK(SAFE_CONVERT(ULLONG_MAX, &f) == ERROR_NONE);  /* Integer to floating rounds */
+    CHECK(SAFE_CONVERT(3.25f, &d) == ERROR_NONE && d == 3.25);
+
+    CHECK(SAFE_CONVERT(1, (int *)NULL) == ERROR_NULL_PARAM);
+}
+
+/* ==========================================================================
+ * FileData lifecycle
+ * ========================================================================== */
+
+static void test_file_data_lifecycle(void)
+{
+    FileData *data = create_file_data(64);
+
+    CHECK(data != NULL);
+    if (data == NULL)
+    {
+        return;
+    }
+    CHECK(data->size == 64);
+    CHECK(data->valid == 1);
+    CHECK(data->content[0] == 0 && data->content[63] == 0);
+
+    destroy_file_data(&data);
+    CHECK(data == NULL);
+
+    destroy_file_data(&data);  /* Destroying NULL is a no-op */
+    destroy_file_data(NULL);
+    CHECK(create_file_data(0) == NULL);
+}
+
+static void test_file_data_recycled_zeroed(void)
+{
+    /* Whether or not the object is recycled, a new FileData is zero and
+     * destroy clears the caller's pointer */
+    for (int round = 0; round < 3; round++)
+    {
+        FileData *data = create_file_data(1000 + (size_t)round * 10);
+
+        CHECK(data != NULL);
+        if (data == NULL)
+        {
+            return;
+        }
+        CHECK(data->size == 1000 + (size_t)round * 10 && data->valid == 1);
+        CHECK(all_zero((const unsigned char *)data->content, data->size));
+        memset(data->content, 'S', data->size);
+
+        destroy_file_data(&data);
+        CHECK(data == NULL);
+    }
+
+    /* Bytes past a lowered size are wiped too, not handed to the next user */
+    FileData *shrunk = create_file_data(100);
+    CHECK(shrunk != NULL);
+    if (shrunk != NULL)
+    {
+        size_t capacity = shrunk->capacity;
+
+        memset(shrunk->content, 'S', capacity);
+        shrunk->size = 10;
+        destroy_file_data(&shrunk);
+        shrunk = create_file_data(100);
+        CHECK(shrunk != NULL && shrunk->capacity == capacity);
+        CHECK(shrunk != NULL && all_zero((const unsigned char *)shrunk->content, capacity));
+        destroy_file_data(&shrunk);
+    }
+
+    /* Large objects bypass the pool */
+    FileData *large = create_file_data(1u << 20);
+    CHECK(large != NULL && all_zero((const unsigned char *)large->content, large->size));
+    destroy_file_data(&large);
+    file_data_pool_trim();
+    file_data_pool_trim();  /* Trimming an empty pool is a no-op */
+}
+
+static void *file_data_worker(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < 100; i++)
+    {
+        FileData *data = create_file_data(64u << (i % 8));
+        if (data == NULL || !all_zero((const unsigned char *)data->content, data->size))
+        {
+            return (void *)1;
+        }
+        memset(data->content, 'T', data->size);
+        destroy_file_data(&data);
+    }
+    return NULL;  /* The thread's pool is freed on exit */
+}
+
+static void test_file_data_pool_threads(void)
+{
+    pthread_t threads[4];
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        CHECK(pthread_create(&threads[i], NULL, file_data_worker, NULL) == 0);
+    }
+    for (size_t i = 0; i < 4; i++)
+    {
+        void *failed = NULL;
+
+        CHECK(pthread_join(threads[i], &failed) == 0);
+        CHECK(failed == NULL);
+    }
+}
+
+static void test_file_data_large_zeroed(void)
+{
+    /* Small (pooled), odd mid-sized (calloc) and large (mapped) buffers */
+    size_t sizes[] = {100, 100000, (64u << 20) + 3};
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        FileData *data = create_file_data(sizes[i]);
+
+        CHECK(data != NULL);
+        if (data == NULL)
+        {
+            return;
+        }
+        CHECK(data->size == sizes[i]);
+        CHECK(data->capacity >= data->size);
+        CHECK(data->content[0] == 0 && data->content[sizes[i] / 2] == 0);
+        CHECK(data->content[sizes[i] - 1] == 0);
+        data->content[sizes[i] - 1] = 'z';  /* Whole range is writable */
+        destroy_file_data(&data);
+        CHECK(data == NULL);
+    }
+}
+
+static void test_file_data_append_grows(void)
+{
+    FileData *data = create_file_data_empty(0);
+
+    CHECK(data != NULL);
+    if (data == NULL)
+    {
+        return;
+    }
+    CHECK(data->size == 0 && data->capacity > 0);
+
+    /* Grow through the pooled classes and past the mapping threshold */
+    char   line[100];
+    size_t moves    = 0;
+    size_t expected = 0;
+    memset(line, 'a', sizeof(line));
+    for (size_t i = 0; i < 30000; i++)
+    {
+        char  *before = data->content;
+        size_t length = 1 + i % sizeof(line);
+
+        line[length - 1] = (char)('b' + i % 20);
+        CHECK(file_data_append(data, line, length) == ERROR_NONE);
+        line[length - 1] = 'a';
+        expected        += length;
+        moves           += (data->content != before);
+    }
+    CHECK(data->size == expected);
+    CHECK(data->capacity > data->size && data->capacity >= (1u << 20));
+    CHECK(data->content[data->size] == '\0');  /* Still NUL-terminated */
+    CHECK(data->content[0] == 'b' && data->content[1] == 'a' && data->content[2] == 'c');
+    CHECK(moves < 32);  /* Geometric growth: logarithmically many moves */
+
+    CHECK(file_data_reserve(data, data->capacity) == ERROR_NONE);  /* No-op */
+    CHECK(file_data_append(data, NULL, 0) == ERROR_NONE);
+    CHECK(file_data_append(data, line, SIZE_MAX) == ERROR_OVERFLOW);
+    CHECK(file_data_append(data, NULL, 1) == ERROR_NULL_PARAM);
+    CHECK(file_data_append(NULL, line, 1) == ERROR_NULL_PARAM);
+    CHECK(file_data_reserve(NULL, 1) == ERROR_NULL_PARAM);
+    CHECK(data->size == expected);
+    destroy_file_data(&data);
+
+    /* A grown buffer is recycled zeroed into its new class */
+    data = create_file_data_empty(16);
+    CHECK(data != NULL);
+    if (data == NULL)
+    {
+        return;
+    }
+    CHECK(file_data_append(data, line, 90) == ERROR_NONE);
+    size_t capacity = data->capacity;
+    destroy_file_data(&data);
+    data = create_file_data(capacity);
+    CHECK(data != NULL);
+    if (data != NULL)
+    {
+        CHECK(all_zero((const unsigned char *)data->content, capacity));
+        destroy_file_data(&data);
+    }
+}
+
+static void test_secure_wipe(void)
+{
+    /* Small, odd-sized/misaligned, and large (streaming) buffers */
+    size_t sizes[] = {1, 15, 4097, (1u << 20) + 13};
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        unsigned char *buffer = malloc(sizes[i] + 2);
+
+        CHECK(buffer != NULL);
+        if (buffer == NULL)
+        {
+            return;
+        }
+        memset(buffer, 0xEE, sizes[i] + 2);
+        secure_wipe(buffer + 1, sizes[i]);
+        CHECK(all_zero(buffer + 1, sizes[i]));
+        CHECK(buffer[0] == 0xEE && buffer[sizes[i] + 1] == 0xEE);  /* Bounds kept */
+        free(buffer);
+    }
+    secure_wipe(NULL, 16);  /* Ignored */
+}
+
+static void test_file_data_inline_lifecycle(void)
+{
+    FileDataInline *data = create_file_data_inline(64);
+
+    CHECK(data != NULL);
+    if (data == NULL)
+    {
+        return;
+    }
+    CHECK(data->size == 64);
+    CHECK(data->valid == 1);
+    CHECK(data->content[0] == 0 && data->content[63] == 0);
+    CHECK(data->content == (char *)data + offsetof(FileDataInline, content));  /* Inline */
+    memcpy(data->content, "payload", 7);
+
+    destroy_file_data_inline(&data);
+    CHECK(data == NULL);
+
+    destroy_file_data_inline(&data);  /* Destroying NULL is a no-op */
+    destroy_file_data_inline(NULL);
+    CHECK(create_file_data_inline(0) == NULL);
+    CHECK(create_file_data_inline(SIZE_MAX) == NULL);
+}
+
+/* ==========================================================================
+ * Error reporting
+ * ========================================================================== */
+
+/* Last event seen by capture_handler() */
+typedef struct CapturedError
+{
+    int        count;
+    ErrorEvent event;
+    char       subject[128];
+} CapturedError;
+
+static void capture_handler(const ErrorEvent *event, void *context)
+{
+    CapturedError *captured = context;
+
+    captured->count++;
+    captured->event = *event;
+    captured->subject[0] = '\0';
+    if (event->subject != NULL)
+    {
+        (void)safe_string_copy(captured->subject, sizeof(captured->subject), event->subject);
+    }
+    errno = EIO;  /* Must not leak to the caller */
+}
+
+static void test_error_reporter_hook(void)
+{
+    CapturedError captured;
+    memset(&captured, 0, sizeof(captured));
+    ErrorReporter reporter = {capture_handler, &captured};
+    char          buffer[16];
+    int           out = 0;
+
+    error_reporter_set(&reporter);
+
+    errno = 0;
+    CHECK(read_config_file("/nonexistent/safe_runtime.cfg", buffer, sizeof(buffer)) ==
+          ERROR_FILE_OPEN);
+    CHECK(captured.count == 1);
+    CHECK(captured.event.severity == ERROR_SEVERITY_ERROR);
+    CHECK(captured.event.code == ERROR_FILE_OPEN);
+    CHECK(captured.event.sys_errno == ENOENT);
+    CHECK(strcmp(captured.event.function, "read_config_file") == 0);
+    CHECK(strcmp(captured.subject, "/nonexistent/safe_runtime.cfg") == 0);
+    CHECK(errno == ENOENT);  /* Caller's errno survives the handler */
+
+#if LONG_MAX > INT_MAX
+    CHECK(convert_long_to_int((long)INT_MAX + 1L, &out) == ERROR_OVERFLOW);
+    CHECK(captured.count == 2);
+    CHECK(captured.event.code == ERROR_OVERFLOW && captured.event.has_value);
+    CHECK(captured.event.value == (long)INT_MAX + 1L);
+#endif
+
+    ConfigView view;
+    int        before = captured.count;
+    CHECK(map_config_file("/tmp", &view) == ERROR_FILE_READ);
+    CHECK(captured.count == before + 1);
+    CHECK(strcmp(captured.event.message, "Not a regular file") == 0);
+    CHECK(captured.event.sys_errno == 0);
+
+    error_reporter_set(NULL);  /* Back to stderr */
+    CHECK(convert_long_to_int(1L, &out) == ERROR_NONE);
+}
+
+static void test_error_ring_records(void)
+{
+    ErrorRing    *ring     = error_ring_create(4);
+    ErrorReporter reporter = {error_ring_handler, ring};
+    ErrorRecord   records[8];
+    char          path[200];
+    char          buffer[16];
+
+    CHECK(ring != NULL);
+    if (ring == NULL)
+    {
+        return;
+    }
+    error_reporter_set(&reporter);
+
+    /* A subject longer than a record keeps its leading bytes */
+    memset(path, 'p', sizeof(path) - 1);
+    path[0]                = '/';
+    path[sizeof(path) - 1] = '\0';
+    CHECK(read_config_file(path, buffer, sizeof(buffer)) == ERROR_FILE_OPEN);
+    CHECK(read_config_file(NULL, buffer, sizeof(buffer)) == ERROR_NULL_PARAM);
+
+    CHECK(error_ring_drain(ring, records, 8) == 2);
+    CHECK(records[0].code == ERROR_FILE_OPEN && records[0].sys_errno != 0);
+    CHECK(strlen(records[0].subject) == ERROR_RECORD_SUBJECT_SIZE - 1);
+    CHECK(memcmp(records[0].subject, path, ERROR_RECORD_SUBJECT_SIZE - 1) == 0);
+    CHECK(records[1].code == ERROR_NULL_PARAM && records[1].subject[0] == '\0');
+    CHECK(strcmp(records[1].function, "read_config_file") == 0);
+    CHECK(error_ring_drain(ring, records, 8) == 0);
+
+    /* Full: new events are dropped and counted, never blocking */
+    for (int i = 0; i < 6; i++)
+    {
+        CHECK(read_config_file(NULL, buffer, sizeof(buffer)) == ERROR_NULL_PARAM);
+    }
+    CHECK(error_ring_dropped(ring) == 2);
+    CHECK(error_ring_drain(ring, records, 8) == 4);
+
+    error_reporter_set(NULL);
+    error_ring_destroy(&ring);
+    CHECK(ring == NULL);
+    error_ring_destroy(&ring);  /* Destroying NULL is a no-op */
+    CHECK(error_ring_drain(NULL, records, 8) == 0 && error_ring_dropped(NULL) == 0);
+}
+
+#define ERROR_STORM_THREADS 4
+#define ERROR_STORM_EVENTS  5000
+
+static void *error_storm_worker(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < ERROR_STORM_EVENTS; i++)
+    {
+        if (read_config_chunks("x", NULL, 1, NULL, NULL, NULL) != ERROR_NULL_PARAM)
+        {
+            return (void *)1;
+        }
+    }
+    return NULL;
+}
+
+static void test_error_ring_concurrent(void)
+{
+    ErrorRing    *ring     = error_ring_create(256);
+    ErrorReporter reporter = {error_ring_handler, ring};
+    pthread_t     threads[ERROR_STORM_THREADS];
+    ErrorRecord   records[64];
+    uint64_t      drained  = 0;
+    int           valid    = 1;
+
+    CHECK(ring != NULL);
+    if (ring == NULL)
+    {
+        return;
+    }
+    error_reporter_set(&reporter);
+    for (size_t i = 0; i < ERROR_STORM_THREADS; i++)
+    {
+        CHECK(pthread_create(&threads[i], NULL, error_storm_worker, NULL) == 0);
+    }
+
+    /* Drain while the producers run */
+    for (int spins = 0; spins < 1000; spins++)
+    {
+        size_t count = error_ring_drain(ring, records, 64);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            valid &= (records[i].code == ERROR_NULL_PARAM);
+        }
+        drained += count;
+    }
+    for (size_t i = 0; i < ERROR_STORM_THREADS; i++)
+    {
+        void *failed = NULL;
+
+        CHECK(pthread_join(threads[i], &failed) == 0);
+        CHECK(failed == NULL);
+    }
+    error_reporter_set(NULL);
+
+    for (size_t count = 1; count != 0; drained += count)
+    {
+        count = error_ring_drain(ring, records, 64);
+    }
+    CHECK(valid);
+    CHECK(drained + error_ring_dropped(ring) ==
+          (uint64_t)ERROR_STORM_THREADS * ERROR_STORM_EVENTS);
+    error_ring_destroy(&ring);
+}
+
+/* ==========================================================================
+ * Asynchronous logger
+ * ========================================================================== */
+
+#define LOG_STORM_THREADS 4
+#define LOG_STORM_LINES   2000
+
+static void *log_storm_worker(void *arg)
+{
+    Logger *logger = arg;
+
+    for (int i = 0; i < LOG_STORM_LINES; i++)
+    {
+        if (logger_log(logger, LOG_LEVEL_INFO, "storm", "worker") != ERROR_NONE)
+        {
+            return (void *)1;
+        }
+    }
+    return NULL;
+}
+
+static void test_logger_threads(void)
+{
+    static char text[LOG_STORM_THREADS * LOG_STORM_LINES * 64];
+    char        path[] = "/tmp/test_safe_runtime_XXXXXX";
+    int         fd     = mkstemp(path);
+    pthread_t   threads[LOG_STORM_THREADS];
+
+    CHECK(fd >= 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    (void)unlink(path);
+
+    /* Room for every record, so none may be dropped */
+    Logger *logger = logger_create(fd, LOG_STORM_THREADS * LOG_STORM_LINES);
+    CHECK(logger != NULL);
+    if (logger == NULL)
+    {
+        (void)close(fd);
+        return;
+    }
+    for (size_t i = 0; i < LOG_STORM_THREADS; i++)
+    {
+        CHECK(pthread_create(&threads[i], NULL, log_storm_worker, logger) == 0);
+    }
+    for (size_t i = 0; i < LOG_STORM_THREADS; i++)
+    {
+        void *failed = NULL;
+
+        CHECK(pthread_join(threads[i], &failed) == 0);
+        CHECK(failed == NULL);
+    }
+
+    logger_flush(logger);
+    CHECK(read_file_lines(fd, text, sizeof(text)) == LOG_STORM_THREADS * LOG_STORM_LINES);
+    CHECK(strstr(text, " INFO storm 'worker'\n") != NULL);
+    CHECK(logger_dropped(logger) == 0);
+
+    /* Destroy writes out what is still buffered */
+    CHECK(logger_log(logger, LOG_LEVEL_DEBUG, "last", NULL) == ERROR_NONE);
+    logger_destroy(&logger);
+    CHECK(logger == NULL);
+    CHECK(read_file_lines(fd, text, sizeof(text)) == LOG_STORM_THREADS * LOG_STORM_LINES + 1);
+    CHECK(strstr(text, " DEBUG last\n") != NULL);
+    (void)close(fd);
+}
+
+static void test_logger_error_handler(void)
+{
+    char   text[1024];
+    char   buffer[16];
+    char   path[] = "/tmp/test_safe_runtime_XXXXXX";
+    int    fd     = mkstemp(path);
+
+    CHECK(fd >= 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    (void)unlink(path);
+
+    Logger *logger = logger_create(fd, 0);
+    CHECK(logger != NULL);
+    if (logger == NULL)
+    {
+        (void)close(fd);
+        return;
+    }
+
+    /* The library's own errors go to the log instead of stderr */
+    ErrorReporter reporter = {logger_error_handler, logger};
+    error_reporter_set(&reporter);
+    CHECK(read_config_file("/nonexistent/log", buffer, sizeof(buffer)) == ERROR_FILE_OPEN);
+    int value = 0;
+    CHECK(convert_long_to_int(LONG_MAX, &value) == ERROR_OVERFLOW);
+    error_reporter_set(NULL);
+
+    logger_flush(logger);
+    CHECK(read_file_lines(fd, text, sizeof(text)) == 2);
+    CHECK(strstr(text, " ERROR read_config_file: ") != NULL);
+    CHECK(strstr(text, "'/nonexistent/log': ") != NULL);
+    CHECK(strstr(text, " ERROR convert_long_to_int: ") != NULL);
+
+    logger_destroy(&logger);
+    (void)close(fd);
+}
+
+typedef struct LogFlood
+{
+    Logger     *logger;
+    atomic_int  stop;
+} LogFlood;
+
+static void *log_flood_worker(void *arg)
+{
+    LogFlood *flood = arg;
+
+    while (!atomic_load(&flood->stop))
+    {
+        (void)logger_log(flood->logger, LOG_LEVEL_DEBUG, "flood", NULL);
+    }
+    return NULL;
+}
+
+static void test_logger_flush_under_load(void)
+{
+    int fd = open("/dev/null", O_WRONLY);
+    CHECK(fd >= 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    LogFlood  flood  = {logger_create(fd, 64), 0};
+    pthread_t thread;
+
+    CHECK(flood.logger != NULL);
+    if (flood.logger == NULL || pthread_create(&thread, NULL, log_flood_worker, &flood) != 0)
+    {
+        logger_destroy(&flood.logger);
+        (void)close(fd);
+        return;
+    }
+
+    /* The ring never drains while the worker floods it; each flush still
+     * returns once what was logged before it is written */
+    for (int i = 0; i < 100; i++)
+    {
+        logger_flush(flood.logger);
+    }
+    atomic_store(&flood.stop, 1);
+    CHECK(pthread_join(thread, NULL) == 0);
+    logger_destroy(&flood.logger);
+    (void)close(fd);
+}
+
+static void test_logger_wakes_on_log(void)
+{
+    char path[] = "/tmp/test_safe_runtime_XXXXXX";
+    char text[128];
+    int  fd     = mkstemp(path);
+
+    CHECK(fd >= 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    (void)unlink(path);
+    Logger *logger = logger_create(fd, 0);
+    CHECK(logger != NULL);
+    if (logger == NULL)
+    {
+        (void)close(fd);
+        return;
+    }
+
+    /* Without a flush, the idle drainer is woken by the log call itself */
+    CHECK(logger_log(logger, LOG_LEVEL_INFO, "wake up", NULL) == ERROR_NONE);
+    size_t lines = 0;
+    for (int tries = 0; tries < 2000 && lines == 0; tries++)
+    {
+        struct timespec pause = {0, 1000000L};
+
+        lines = read_file_lines(fd, text, sizeof(text));
+        (void)nanosleep(&pause, NULL);
+    }
+    CHECK(lines == 1 && strstr(text, " INFO wake up\n") != NULL);
+    logger_destroy(&logger);
+    (void)close(fd);
+}
+
+static void test_logger_errors(void)
+{
+    CHECK(logger_create(-1, 0) == NULL);
+    CHECK(logger_log(NULL, LOG_LEVEL_INFO, "x", NULL) == ERROR_NULL_PARAM);
+    CHECK(logger_dropped(NULL) == 0);
+    logger_flush(NULL);
+    logger_destroy(NULL);
+
+    /* Writes to a read-only descriptor fail; those records count as dropped */
+    int fd = open("/dev/null", O_RDONLY);
+    CHECK(fd >= 0);
+    if (fd < 0)
+    {
+        return;
+    }
+    Logger *logger = logger_create(fd, 4);
+    CHECK(logger != NULL);
+    if (logger != NULL)
+    {
+        CHECK(logger_log(logger, LOG_LEVEL_INFO, NULL, NULL) == ERROR_NULL_PARAM);
+        for (int i = 0; i < 3; i++)
+        {
+            CHECK(logger_log(logger, LOG_LEVEL_WARNING, "lost", NULL) == ERROR_NONE);
+            logger_flush(logger);
+        }
+        CHECK(logger_dropped(logger) == 3);
+        logger_destroy(&logger);
+    }
+    (void)close(fd);
+}
+
+/* ==========================================================================
+ * Arena allocation
+ * ========================================================================== */
+
+static void test_arena_alloc_zeroed_and_aligned(void)
+{
+    Arena *arena = arena_create(256);
+
+    CHECK(arena != NULL);
+    if (arena == NULL)
+    {
+        return;
+    }
+    for (size_t size = 1; size < 600; size += 37)  /* Includes oversized requests */
+    {
+        unsigned char *memory = arena_alloc(arena, size);
+
+        CHECK(memory != NULL);
+        CHECK((uintptr_t)memory % _Alignof(max_align_t) == 0);
+        CHECK(memory != NULL && all_zero(memory, size));
+        if (memory != NULL)
+        {
+            memset(memory, 0xAB, size);
+        }
+    }
+    CHECK(arena_alloc(arena, 0) == NULL);
+    CHECK(arena_alloc(NULL, 8) == NULL);
+    CHECK(arena_alloc(arena, SIZE_MAX) == NULL);
+
+    /* Memory handed out again after a reset is zero once more */
+    arena_reset(arena);
+    unsigned char *reused = arena_alloc(arena, 200);
+    CHECK(reused != NULL && all_zero(reused, 200));
+
+    arena_destroy(&arena);
+    CHECK(arena == NULL);
+    arena_destroy(&arena);  /* Destroying NULL is a no-op */
+    arena_destroy(NULL);
+}
+
+static void test_arena_rewind(void)
+{
+    Arena *arena = arena_create(128);
+
+    CHECK(arena != NULL);
+    if (arena == NULL)
+    {
+        return;
+    }
+    char     *kept = arena_alloc(arena, 16);
+    ArenaMark mark = arena_mark(arena);
+
+    for (int i = 0; i < 20; i++)  /* Spill into several new blocks */
+    {
+        char *scratch = arena_alloc(arena, 64);
+        CHECK(scratch != NULL);
+        if (scratch != NULL)
+        {
+            memset(scratch, 'x', 64);
+        }
+    }
+    arena_rewind(arena, mark);
+
+    /* The next allocation lands right after the kept one, wiped */
+    char *next = arena_alloc(arena, 16);
+    CHECK(kept != NULL && next == kept + 16);
+    CHECK(next != NULL && all_zero((const unsigned char *)next, 16));
+
+    arena_rewind(NULL, mark);
+    arena_destroy(&arena);
+}
+
+static void test_create_file_data_in_arena(void)
+{
+    Arena    *arena = arena_create(0);
+    FileData *data  = create_file_data_in(arena, 64);
+
+    CHECK(data != NULL);
+    if (data == NULL)
+    {
+        arena_destroy(&arena);
+        return;
+    }
+    CHECK(data->size == 64 && data->valid == 1 && data->arena == arena);
+    CHECK(all_zero((const unsigned char *)data->content, 64));
+
+    memcpy(data->content, "secret", 6);
+    char *content = data->content;
+    destroy_file_data(&data);
+    CHECK(data == NULL);
+    CHECK(all_zero((const unsigned char *)content, 64));  /* Wiped in place */
+
+    /* Growing an arena FileData moves it within the arena */
+    data = create_file_data_in(arena, 8);
+    CHECK(data != NULL);
+    if (data != NULL)
+    {
+        memcpy(data->content, "arena", 5);
+        content = data->content;
+        CHECK(file_data_append(data, "-grown", 6) == ERROR_NONE);
+        CHECK(data->capacity >= 15 && memcmp(data->content, "arena\0\0\0-grown", 15) == 0);
+        CHECK(data->content[data->size] == '\0');
+        CHECK(all_zero((const unsigned char *)content, 8));  /* Old copy wiped */
+        destroy_file_data(&data);
+    }
+
+    /* Without an arena it is create_file_data() */
+    data = create_file_data_in(NULL, 8);
+    CHECK(data != NULL && data->arena == NULL);
+    destroy_file_data(&data);
+    CHECK(create_file_data_in(arena, 0) == NULL);
+    arena_destroy(&arena);
+}
+
+static void test_process_data_in_arena(void)
+{
+    Arena *arena = arena_create(0);
+
+    CHECK(arena != NULL);
+    if (arena == NULL)
+    {
+        return;
+    }
+    void     *before = arena_alloc(arena, 1);
+    ArenaMark mark   = arena_mark(arena);
+
+    CHECK(process_data_in(arena, "Hello from arena") == ERROR_NONE);
+    CHECK(process_data_in(arena, NULL) == ERROR_NULL_PARAM);
+    CHECK(process_data_in(NULL, "Hello from heap") == ERROR_NONE);
+
+    /* The scratch buffer was given back */
+    ArenaMark after = arena_mark(arena);
+    CHECK(before != NULL && after.block == mark.block && after.used == mark.used);
+    arena_destroy(&arena);
+}
+
+int main(void)
+{
+    test_safe_string_copy_fits();
+    test_safe_string_copy_truncates();
+    test_safe_string_copy_rejects_bad_params();
+    test_safe_string_copy_matches_reference();
+    test_safe_string_copy_at_page_end();
+    test_safe_string_copy_bounded_reports_truncation();
+    test_safe_string_copy_bounded_rejects_bad_params();
+    test_safe_string_copy_bounded_reads_at_most_dest_size();
+    test_safe_string_copy_batch_sets_truncation_bits();
+    test_safe_string_copy_batch_validates_before_copying();
+    test_read_config_file_reads_content();
+    test_read_config_file_truncates_to_buffer();
+    test_read_config_file_missing_file();
+    test_map_config_file_maps_content();
+    test_map_config_file_empty_file();
+    test_map_config_file_errors();
+    test_read_config_chunks_streams_whole_file();
+    test_config_reader_iterates();
+    test_config_reader_errors();
+    test_read_config_file_cached_hits_and_revalidates();
+    test_read_config_file_cached_errors();
+    test_read_config_file_cached_concurrent();
+    test_load_config_files();
+    test_load_config_files_large();
+    test_load_config_files_errors();
+    test_process_data();
+    test_process_data_batch();
+    test_convert_long_to_int();
+    test_convert_long_array_to_int();
+    test_safe_convert_generic();
+    test_file_data_lifecycle();
+    test_file_data_recycled_zeroed();
+    test_file_data_pool_threads();
+    test_file_data_large_zeroed();
+    test_file_data_append_grows();
+    test_secure_wipe();
+    test_file_data_inline_lifecycle();
+    test_error_reporter_hook();
+    test_error_ring_records();
+    test_error_ring_concurrent();
+    test_logger_threads();
+    test_logger_error_handler();
+    test_logger_flush_under_load();
+    test_logger_wakes_on_log();
+    test_logger_errors();
+    test_arena_alloc_zeroed_and_aligned();
+    test_arena_rewind();
+    test_create_file_data_in_arena();
+    test_process_data_in_arena();
+
+    if (g_failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    printf("All safe_runtime tests passed\n");
+    return EXIT_SUCCESS;
+}